@@ -3,6 +3,11 @@
 // Do not use to train AI / LLM / neural network
 
 #include "Saving/SaveData.h"
+#include "Misc/StringBuilder.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+#include "UObject/PropertyTag.h"
 
 //==============================================================================================================
 //
@@ -103,4 +108,430 @@ void FCustomSaveData::_GetSizeString(	int32 InMegabytes,
 	{
 		OutString = FString::Printf(TEXT("%d b"), InBytes);
 	}
-}
\ No newline at end of file
+}
+
+//==============================================================================================================
+//
+//==============================================================================================================
+bool FCustomSaveData::MatchesTag(const FName &InTag) const
+{
+	if (ParentTag.IsNone())
+		return Tag == InTag;
+
+	FName SplitParentTag, SplitTag;
+	FCustomSaveData::SplitTag(InTag, SplitParentTag, SplitTag);
+	return MatchesTag(InTag, SplitParentTag, SplitTag);
+}
+
+//==============================================================================================================
+//
+//==============================================================================================================
+bool FCustomSaveData::MatchesTag(const FName &InTag, const FName &InSplitParentTag, const FName &InSplitTag) const
+{
+	//Older saves stored the full tag
+	if (ParentTag.IsNone())
+		return Tag == InTag;
+
+	return !InSplitParentTag.IsNone() && ParentTag == InSplitParentTag && Tag == InSplitTag;
+}
+
+//==============================================================================================================
+//
+//==============================================================================================================
+void FCustomSaveData::SplitTag(const FName &InTag, FName &OutParentTag, FName &OutTag)
+{
+	OutParentTag = NAME_None;
+	OutTag = InTag;
+
+	if (InTag.IsNone())
+		return;
+
+	TStringBuilder<128> FullTag;
+	FullTag << InTag;
+
+	int32 iDot = INDEX_NONE;
+	if (!FullTag.ToView().FindLastChar(TEXT('.'), iDot))
+		return;
+
+	OutParentTag = FName(FullTag.ToView().Left(iDot), FNAME_Find);
+	OutTag = FName(FullTag.ToView().RightChop(iDot + 1), FNAME_Find);
+}
+
+//==============================================================================================================
+//
+//==============================================================================================================
+FName FCustomSaveData::MakeChildTag(const FName &InParentTag, const FName &InTag)
+{
+	if (InParentTag.IsNone() || InTag.IsNone())
+		return InTag;
+
+	TStringBuilder<128> FullTag;
+	FullTag << InParentTag << TEXT('.') << InTag;
+	return FName(FullTag.ToView());
+}
+
+//==============================================================================================================
+//
+//==============================================================================================================
+bool FCustomSaveData::IsChildTag(const FName &InParentTag, const FName &InTag) const
+{
+	if (!ParentTag.IsNone())
+		return ParentTag == InParentTag && Tag == InTag;
+
+	//Older saves stored the full tag
+	TStringBuilder<128> FullTag;
+	FullTag << InParentTag << TEXT('.') << InTag;
+
+	TStringBuilder<128> SavedTag;
+	SavedTag << Tag;
+
+	return FullTag.ToView().Equals(SavedTag.ToView(), ESearchCase::IgnoreCase);
+}
+
+//==============================================================================================================
+//
+//==============================================================================================================
+FString FCustomSaveData::GetTagString() const
+{
+	if (ParentTag.IsNone())
+		return Tag.ToString();
+
+	return ParentTag.ToString() + TEXT(".") + Tag.ToString();
+}
+
+//==============================================================================================================
+//
+//==============================================================================================================
+void FSavedTransform::Set(const FTransform &InTransform, bool InQuantize)
+{
+	Transform = InTransform;
+	bIsSet = true;
+	bQuantize = InQuantize;
+}
+
+//==============================================================================================================
+// Largest component is left out and calculated from the other three on load
+//==============================================================================================================
+static const double SmallestThreeRange = 0.70710678118654752;
+static const uint64 SmallestThreeMax = (1 << 15) - 1;
+
+FORCEINLINE static uint64 PackSmallestThree(const FQuat &InQuat)
+{
+	FQuat Quat = InQuat.GetNormalized();
+	double Components[4] = { Quat.X, Quat.Y, Quat.Z, Quat.W };
+
+	int32 iLargest = 0;
+	for (int32 i=1; i<4; i++)
+	{
+		if (FMath::Abs(Components[i]) > FMath::Abs(Components[iLargest]))
+		{
+			iLargest = i;
+		}
+	}
+
+	//Both signs are the same rotation
+	const double Sign = Components[iLargest] < 0.0 ? -1.0 : 1.0;
+
+	uint64 Packed = (uint64)iLargest;
+	int32 iShift = 2;
+	for (int32 i=0; i<4; i++)
+	{
+		if (i == iLargest)
+			continue;
+
+		const double Normalized = FMath::Clamp((Components[i] * Sign / SmallestThreeRange + 1.0) * 0.5, 0.0, 1.0);
+		Packed |= ((uint64)FMath::RoundToInt(Normalized * SmallestThreeMax)) << iShift;
+		iShift += 15;
+	}
+
+	return Packed;
+}
+
+FORCEINLINE static FQuat UnpackSmallestThree(uint64 InPacked)
+{
+	const int32 iLargest = (int32)(InPacked & 3);
+
+	double Components[4];
+	double SumSquared = 0.0;
+	int32 iShift = 2;
+	for (int32 i=0; i<4; i++)
+	{
+		if (i == iLargest)
+			continue;
+
+		const double Normalized = (double)((InPacked >> iShift) & SmallestThreeMax) / SmallestThreeMax;
+		Components[i] = (Normalized * 2.0 - 1.0) * SmallestThreeRange;
+		SumSquared += Components[i] * Components[i];
+		iShift += 15;
+	}
+
+	Components[iLargest] = FMath::Sqrt(FMath::Max(0.0, 1.0 - SumSquared));
+
+	FQuat Quat(Components[0], Components[1], Components[2], Components[3]);
+	Quat.Normalize();
+	return Quat;
+}
+
+//==============================================================================================================
+// Writes a float or a double
+//==============================================================================================================
+FORCEINLINE static void SerializeReal(FArchive &Ar, double &InOutValue, bool InQuantize)
+{
+	if (InQuantize)
+	{
+		float Value = (float)InOutValue;
+		Ar << Value;
+		InOutValue = Value;
+	}
+	else
+	{
+		Ar << InOutValue;
+	}
+}
+
+//==============================================================================================================
+// Identity parts are left out. Locations are in the space they were 
+// saved in, the level for actors and the parent for components and
+// attached actors. They stay doubles even when quantized so large
+// worlds don't lose precision away from the origin
+//==============================================================================================================
+bool FSavedTransform::Serialize(FArchive &Ar)
+{
+	enum
+	{
+		SAVED_SET = 1 << 0,
+		SAVED_QUANTIZED = 1 << 1,
+		SAVED_LOCATION = 1 << 2,
+		SAVED_ROTATION = 1 << 3,
+		SAVED_SCALE = 1 << 4,
+		SAVED_UNIFORM_SCALE = 1 << 5,
+	};
+
+	uint8 Flags = 0;
+	double Location[3] = { 0.0, 0.0, 0.0 };
+	double Scale[3] = { 1.0, 1.0, 1.0 };
+	FQuat Rotation = FQuat::Identity;
+
+	if (Ar.IsSaving() && bIsSet)
+	{
+		Flags |= SAVED_SET;
+		if (bQuantize)
+		{
+			Flags |= SAVED_QUANTIZED;
+		}
+
+		const FVector SavedLocation = Transform.GetLocation();
+		Location[0] = SavedLocation.X;
+		Location[1] = SavedLocation.Y;
+		Location[2] = SavedLocation.Z;
+		if (!SavedLocation.IsZero())
+		{
+			Flags |= SAVED_LOCATION;
+		}
+
+		Rotation = Transform.GetRotation();
+		if (!Rotation.Equals(FQuat::Identity, 0.0f))
+		{
+			Flags |= SAVED_ROTATION;
+		}
+
+		const FVector SavedScale = Transform.GetScale3D();
+		Scale[0] = SavedScale.X;
+		Scale[1] = SavedScale.Y;
+		Scale[2] = SavedScale.Z;
+		if (!SavedScale.Equals(FVector::OneVector, 0.0f))
+		{
+			Flags |= SAVED_SCALE;
+			if (SavedScale.AllComponentsEqual(0.0f))
+			{
+				Flags |= SAVED_UNIFORM_SCALE;
+			}
+		}
+	}
+
+	Ar << Flags;
+
+	const bool bQuantized = (Flags & SAVED_QUANTIZED) != 0;
+
+	if (Flags & SAVED_LOCATION)
+	{
+		for (int32 i=0; i<3; i++)
+		{
+			Ar << Location[i];
+		}
+	}
+
+	if (Flags & SAVED_ROTATION)
+	{
+		if (bQuantized)
+		{
+			//48 bits, index of the largest component and 15 bits for each of the others
+			uint64 Packed = Ar.IsSaving() ? PackSmallestThree(Rotation) : 0;
+			uint32 Low = (uint32)(Packed & 0xFFFFFFFF);
+			uint16 High = (uint16)(Packed >> 32);
+			Ar << Low;
+			Ar << High;
+			Rotation = UnpackSmallestThree(((uint64)High << 32) | Low);
+		}
+		else
+		{
+			double Components[4] = { Rotation.X, Rotation.Y, Rotation.Z, Rotation.W };
+			for (int32 i=0; i<4; i++)
+			{
+				Ar << Components[i];
+			}
+			Rotation = FQuat(Components[0], Components[1], Components[2], Components[3]);
+		}
+	}
+
+	if (Flags & SAVED_UNIFORM_SCALE)
+	{
+		SerializeReal(Ar, Scale[0], bQuantized);
+		Scale[1] = Scale[0];
+		Scale[2] = Scale[0];
+	}
+	else if (Flags & SAVED_SCALE)
+	{
+		for (int32 i=0; i<3; i++)
+		{
+			SerializeReal(Ar, Scale[i], bQuantized);
+		}
+	}
+
+	if (Ar.IsLoading())
+	{
+		bIsSet = (Flags & SAVED_SET) != 0;
+		bQuantize = bQuantized;
+		Transform = FTransform(Rotation, FVector(Location[0], Location[1], Location[2]), FVector(Scale[0], Scale[1], Scale[2]));
+	}
+
+	return true;
+}
+
+//==============================================================================================================
+// 
+//==============================================================================================================
+bool FSavedTransform::SerializeFromMismatchedTag(const FPropertyTag &Tag, FStructuredArchive::FSlot Slot)
+{
+	if (Tag.Type == NAME_StructProperty && Tag.StructName == NAME_Transform)
+	{
+		FTransform Legacy;
+		TBaseStructure<FTransform>::Get()->SerializeItem(Slot, &Legacy, NULL);
+		Set(Legacy, false);
+		return true;
+	}
+
+	return false;
+}
+
+//==============================================================================================================
+// Names and soft classes are written as strings so the blob doesn't
+// depend on the name table of the session that packed it
+//==============================================================================================================
+void FLevelSaveData::Pack()
+{
+	if (IsPacked() || (Actors.Num() == 0 && CustomObjects.Num() == 0))
+		return;
+
+	PackedData.Reset();
+	PackedOffsets.Reset(Actors.Num() + CustomObjects.Num());
+
+	FMemoryWriter Writer(PackedData, true);
+	FObjectAndNameAsStringProxyArchive Archive(Writer, false);
+
+	for (int32 i=0; i<Actors.Num(); i++)
+	{
+		PackedOffsets.Add(PackedData.Num());
+		FActorSaveData::StaticStruct()->SerializeItem(Archive, &Actors.GetData()[i], NULL);
+	}
+
+	for (int32 i=0; i<CustomObjects.Num(); i++)
+	{
+		PackedOffsets.Add(PackedData.Num());
+		FCustomSaveData::StaticStruct()->SerializeItem(Archive, &CustomObjects.GetData()[i], NULL);
+	}
+
+	PackedActors = Actors.Num();
+	PackedData.Shrink();
+
+	Actors.Empty();
+	CustomObjects.Empty();
+}
+
+//==============================================================================================================
+//
+//==============================================================================================================
+void FLevelSaveData::Unpack()
+{
+	if (!IsPacked())
+		return;
+
+	FMemoryReader Reader(PackedData, true);
+	FObjectAndNameAsStringProxyArchive Archive(Reader, false);
+
+	Actors.SetNum(PackedActors);
+	for (int32 i=0; i<PackedActors; i++)
+	{
+		Reader.Seek(PackedOffsets.GetData()[i]);
+		FActorSaveData::StaticStruct()->SerializeItem(Archive, &Actors.GetData()[i], NULL);
+	}
+
+	CustomObjects.SetNum(PackedOffsets.Num() - PackedActors);
+	for (int32 i=0; i<CustomObjects.Num(); i++)
+	{
+		Reader.Seek(PackedOffsets.GetData()[PackedActors + i]);
+		FCustomSaveData::StaticStruct()->SerializeItem(Archive, &CustomObjects.GetData()[i], NULL);
+	}
+
+	PackedData.Empty();
+	PackedOffsets.Empty();
+	PackedActors = 0;
+}
+
+//==============================================================================================================
+//
+//==============================================================================================================
+void FLevelSaveData::ResetRecords()
+{
+	Actors.Reset();
+	CustomObjects.Reset();
+	SharedPayloads.Reset();
+
+	PackedData.Empty();
+	PackedOffsets.Empty();
+	PackedActors = 0;
+}
+
+//==============================================================================================================
+//
+//==============================================================================================================
+bool FLevelSaveData::GetPackedActor(int32 InIndex, FActorSaveData &OutData) const
+{
+	if (InIndex < 0 || InIndex >= PackedActors)
+		return false;
+
+	FMemoryReader Reader(PackedData, true);
+	FObjectAndNameAsStringProxyArchive Archive(Reader, false);
+	Reader.Seek(PackedOffsets.GetData()[InIndex]);
+
+	OutData = FActorSaveData();
+	FActorSaveData::StaticStruct()->SerializeItem(Archive, &OutData, NULL);
+	return true;
+}
+
+//==============================================================================================================
+//
+//==============================================================================================================
+bool FLevelSaveData::GetPackedObject(int32 InIndex, FCustomSaveData &OutData) const
+{
+	if (InIndex < 0 || PackedActors + InIndex >= PackedOffsets.Num())
+		return false;
+
+	FMemoryReader Reader(PackedData, true);
+	FObjectAndNameAsStringProxyArchive Archive(Reader, false);
+	Reader.Seek(PackedOffsets.GetData()[PackedActors + InIndex]);
+
+	OutData = FCustomSaveData();
+	FCustomSaveData::StaticStruct()->SerializeItem(Archive, &OutData, NULL);
+	return true;
+}
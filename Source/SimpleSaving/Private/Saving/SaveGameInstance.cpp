@@ -10,6 +10,8 @@
 #include "Saving/SimpleSaveHeader.h"
 #include "Saving/SaveInterface.h"
 #include "Saving/SimpleRestoreHandler.h"
+#include "Saving/SimpleRewindBuffer.h"
+#include "Saving/SimpleSavePrefetch.h"
 
 //==============================================================================================================
 //
@@ -25,10 +27,11 @@ USaveGameInstance::USaveGameInstance(const FObjectInitializer &ObjectInitializer
 //=================================================================
 // 
 //=================================================================
-void USaveGameInstance::StartLoading(class USimpleSaveFile *InLoadGame)
+void USaveGameInstance::StartLoading(class USimpleSaveFile *InLoadGame, bool InRestoreInPlace)
 {
 	LoadGame = InLoadGame;
 	bIsLoading = true;
+	bRestoringInPlace = InRestoreInPlace;
 	bInLevelChange = false;
 	UE_LOG(LogTemp, Display, TEXT("bInLevelChange set to false by StartLoading!"));
 }
@@ -46,9 +49,15 @@ void USaveGameInstance::FinishLoading(class UObject *WorldContextObject)
 	}
 
 	bIsLoading = false;
+	bRestoringInPlace = false;
 	bInLevelChange = false;
 	UE_LOG(LogTemp, Display, TEXT("bInLevelChange set to false by FinishLoading!"));
 
+	if (SavePrefetch)
+	{
+		SavePrefetch->ReleaseLoads();
+	}
+
 	if (!OnRestoreFinished.IsBound() && UseRestoreHandler)
 	{
 		ISimpleSavingLoadingScreenModule& LoadingScreenModule = ISimpleSavingLoadingScreenModule::Get();
@@ -111,6 +120,11 @@ bool USaveGameInstance::HandleRestore(class UObject *WorldContextObject, bool St
 			LoadGame->HandleRestore(WorldContextObject, OutTimeSkip, TriggerPostLevelChange);
 		}
 	}
+	else if (UseDeltaSaving())
+	{
+		//New game or a level opened without a save, restores take the baseline themselves
+		CaptureLevelBaseline(WorldContextObject);
+	}
 
 	//Intentionally negative so that if the game gets save one second from Now, then the value will be
 	//-Now + (1.0f + Now) = 1.0f from GetTotalTime()
@@ -170,6 +184,52 @@ bool USaveGameInstance::PreChangeLevel(class UObject *WorldContextObject, const
 	return true;
 }
 
+//=================================================================
+// Placed actors are saved against this so only the player's
+// changes to the level end up in the save
+//=================================================================
+void USaveGameInstance::CaptureLevelBaseline(class UObject *WorldContextObject)
+{
+	LevelBaseline.Reset();
+	BaselineLevel = *UGameplayStatics::GetCurrentLevelName(WorldContextObject);
+
+	TArray<class AActor*> AllActors;
+	UGameplayStatics::GetAllActorsWithInterface(WorldContextObject, USaveInterface::StaticClass(), AllActors);
+
+	for (int32 i=0; i<AllActors.Num(); i++)
+	{
+		class AActor *pActor = AllActors.GetData()[i];
+
+		//Recreated actors are always saved in full
+		ISaveInterface *pInterface = Cast<ISaveInterface>(pActor);
+		if (!pInterface || !pInterface->ShouldSave() || pInterface->ShouldDeleteOnRestore())
+			continue;
+
+		FSimpleLevelBaseline ActorBaseline;
+		ActorBaseline.Transform = pActor->GetActorTransform();
+		USimpleSaveFile::SaveBaselineProperties(pActor, ActorBaseline.Data);
+		LevelBaseline.Add(pActor, MoveTemp(ActorBaseline));
+
+		TArray<class UActorComponent*> Components;
+		pActor->GetComponents(Components);
+		for (int32 j=0; j<Components.Num(); j++)
+		{
+			FSimpleLevelBaseline ComponentBaseline;
+
+			class USceneComponent *pScene = Cast<USceneComponent>(Components.GetData()[j]);
+			if (pScene)
+			{
+				ComponentBaseline.Transform = pScene->GetRelativeTransform();
+			}
+
+			USimpleSaveFile::SaveBaselineProperties(Components.GetData()[j], ComponentBaseline.Data);
+			LevelBaseline.Add(Components.GetData()[j], MoveTemp(ComponentBaseline));
+		}
+	}
+
+	UE_LOG(LogTemp, Verbose, TEXT("Captured delta saving baseline of %d objects in %s"), LevelBaseline.Num(), *BaselineLevel.ToString());
+}
+
 //=================================================================
 // 
 //=================================================================
@@ -228,7 +288,7 @@ bool USaveGameInstance::ChangeLevel(class UObject *WorldContextObject, TSoftObje
 		ISimpleSavingLoadingScreenModule& LoadingScreenModule = ISimpleSavingLoadingScreenModule::Get();
 		LoadingScreenModule.StartInGameLoadingScreen(true, 1.0f);
 
-		GEngine->ForceGarbageCollection(true);
+		//Loading the map collects the old world, a forced full purge here would only run the collection twice
 		UGameplayStatics::OpenLevelBySoftObjectPtr(WorldContextObject, InLevel);
 		return true;
 	}
@@ -425,6 +485,14 @@ void USaveGameInstance::SortSaveFiles()
 //=================================================================
 bool USaveGameInstance::UpdateSaveFile(const FString &InFilename)
 {
+	ScreenshotCache.Invalidate(InFilename);
+
+	//Prefetched before it was saved over
+	if (SavePrefetch)
+	{
+		SavePrefetch->CancelFor(InFilename);
+	}
+
 	if (SaveFiles.Num() == 0)
 	{
 		GenerateSaveFileList();
@@ -456,3 +524,65 @@ bool USaveGameInstance::UpdateSaveFile(const FString &InFilename)
 
 	return true;
 }
+
+//=================================================================
+// 
+//=================================================================
+class USimpleRewindBuffer *USaveGameInstance::GetRewindBuffer()
+{
+	if (!RewindBuffer)
+	{
+		RewindBuffer = NewObject<USimpleRewindBuffer>(this);
+	}
+
+	return RewindBuffer;
+}
+
+//=================================================================
+// 
+//=================================================================
+class USimpleSavePrefetch *USaveGameInstance::GetSavePrefetch()
+{
+	if (!SavePrefetch)
+	{
+		SavePrefetch = NewObject<USimpleSavePrefetch>(this);
+	}
+
+	return SavePrefetch;
+}
+
+//=================================================================
+// 
+//=================================================================
+FDateTime USaveGameInstance::GetSaveFileTime(const FString &InFilename) const
+{
+	for (int32 i=0; i<SaveFiles.Num(); i++)
+	{
+		if (SaveFiles.GetData()[i].Filename.Equals(InFilename, ESearchCase::IgnoreCase))
+			return SaveFiles.GetData()[i].DateTime;
+	}
+
+	return FDateTime::MinValue();
+}
+
+//=================================================================
+// 
+//=================================================================
+FScreenshotCache &USaveGameInstance::GetScreenshotCache()
+{
+	ScreenshotCache.SetBudget((int64)ScreenshotCacheKilobytes * 1024);
+	return ScreenshotCache;
+}
+
+//=================================================================
+// 
+//=================================================================
+void USaveGameInstance::OnScreenshotsWritten(const TArray<FString> &InFilenames)
+{
+	for (int32 i=0; i<InFilenames.Num(); i++)
+	{
+		ScreenshotCache.Invalidate(InFilenames.GetData()[i]);
+	}
+
+	ScreenshotAtlasVersion++;
+}
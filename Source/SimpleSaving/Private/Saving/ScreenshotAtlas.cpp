@@ -0,0 +1,352 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#include "Saving/ScreenshotAtlas.h"
+#include "Saving/SimpleSaveHeader.h"
+#include "Engine/Texture2D.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+//=============================================================================================================================
+//
+//=============================================================================================================================
+static const uint32 AtlasMagic = 0x54415353; // SSAT
+static const int32 AtlasVersion = 1;
+
+//=============================================================================================================================
+// Each block is two 565 colors and 2 bits per pixel
+//=============================================================================================================================
+static const int32 BlockBytes = 8;
+
+//=============================================================================================================================
+//
+//=============================================================================================================================
+FString FScreenshotAtlas::GetAtlasFilename()
+{
+	return FPaths::ProjectSavedDir() + TEXT("SaveGames/Header/Atlas.bin");
+}
+
+//=============================================================================================================================
+//
+//=============================================================================================================================
+int32 FScreenshotAtlas::GetThumbnailBytes()
+{
+	return (ThumbnailWide / 4) * (ThumbnailTall / 4) * BlockBytes;
+}
+
+//=============================================================================================================================
+// 
+//=============================================================================================================================
+FORCEINLINE static uint16 To565(int32 InR, int32 InG, int32 InB)
+{
+	return (uint16)(((InR >> 3) << 11) | ((InG >> 2) << 5) | (InB >> 3));
+}
+
+//=============================================================================================================================
+// 
+//=============================================================================================================================
+FORCEINLINE static void From565(uint16 InColor, int32 *OutColor)
+{
+	const int32 r = (InColor >> 11) & 31;
+	const int32 g = (InColor >> 5) & 63;
+	const int32 b = InColor & 31;
+	OutColor[0] = (r << 3) | (r >> 2);
+	OutColor[1] = (g << 2) | (g >> 4);
+	OutColor[2] = (b << 3) | (b >> 2);
+}
+
+//=============================================================================================================================
+// Bounding box of the block inset a little as the endpoints, which is cheap and good enough for a thumbnail
+//=============================================================================================================================
+void FScreenshotAtlas::CompressBlock(const FColor *InPixels, int32 InStride, uint8 *OutBlock)
+{
+	int32 Min[3] = { 255, 255, 255 };
+	int32 Max[3] = { 0, 0, 0 };
+	for (int32 y=0; y<4; y++)
+	{
+		for (int32 x=0; x<4; x++)
+		{
+			const FColor &Pixel = InPixels[y * InStride + x];
+			Min[0] = FMath::Min(Min[0], (int32)Pixel.R); Max[0] = FMath::Max(Max[0], (int32)Pixel.R);
+			Min[1] = FMath::Min(Min[1], (int32)Pixel.G); Max[1] = FMath::Max(Max[1], (int32)Pixel.G);
+			Min[2] = FMath::Min(Min[2], (int32)Pixel.B); Max[2] = FMath::Max(Max[2], (int32)Pixel.B);
+		}
+	}
+
+	for (int32 c=0; c<3; c++)
+	{
+		const int32 iInset = (Max[c] - Min[c]) >> 4;
+		Min[c] += iInset;
+		Max[c] -= iInset;
+	}
+
+	uint16 Color0 = To565(Max[0], Max[1], Max[2]);
+	uint16 Color1 = To565(Min[0], Min[1], Min[2]);
+	uint32 Indices = 0;
+
+	//Only the four color mode is used, it needs the first color to be larger
+	if (Color0 < Color1)
+	{
+		Swap(Color0, Color1);
+	}
+
+	if (Color0 != Color1)
+	{
+		int32 Palette[4][3];
+		From565(Color0, Palette[0]);
+		From565(Color1, Palette[1]);
+		for (int32 c=0; c<3; c++)
+		{
+			Palette[2][c] = (2 * Palette[0][c] + Palette[1][c]) / 3;
+			Palette[3][c] = (Palette[0][c] + 2 * Palette[1][c]) / 3;
+		}
+
+		for (int32 i=0; i<16; i++)
+		{
+			const FColor &Pixel = InPixels[(i / 4) * InStride + (i % 4)];
+
+			int32 iBest = 0;
+			int32 iBestDistance = MAX_int32;
+			for (int32 p=0; p<4; p++)
+			{
+				const int32 dr = Palette[p][0] - Pixel.R;
+				const int32 dg = Palette[p][1] - Pixel.G;
+				const int32 db = Palette[p][2] - Pixel.B;
+				const int32 iDistance = dr * dr + dg * dg + db * db;
+				if (iDistance < iBestDistance)
+				{
+					iBestDistance = iDistance;
+					iBest = p;
+				}
+			}
+
+			Indices |= (uint32)iBest << (i * 2);
+		}
+	}
+
+	OutBlock[0] = (uint8)(Color0 & 0xFF);
+	OutBlock[1] = (uint8)(Color0 >> 8);
+	OutBlock[2] = (uint8)(Color1 & 0xFF);
+	OutBlock[3] = (uint8)(Color1 >> 8);
+	OutBlock[4] = (uint8)(Indices & 0xFF);
+	OutBlock[5] = (uint8)((Indices >> 8) & 0xFF);
+	OutBlock[6] = (uint8)((Indices >> 16) & 0xFF);
+	OutBlock[7] = (uint8)(Indices >> 24);
+}
+
+//=============================================================================================================================
+// The screenshot is stretched to the thumbnail so every save takes the same space in the atlas
+//=============================================================================================================================
+bool FScreenshotAtlas::CompressThumbnail(int32 InSizeX, int32 InSizeY, const TArray<FColor> &InImageData, TArray<uint8> &OutBlocks)
+{
+	if (InSizeX < ThumbnailWide || InSizeY < ThumbnailTall || InImageData.Num() < InSizeX * InSizeY)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FScreenshotAtlas::CompressThumbnail: Screenshot is smaller than the thumbnail!"));
+		return false;
+	}
+
+	TArray<FColor> Thumbnail;
+	USimpleSaveHeader::DownscaleScreenshot(InSizeX, InSizeY, InImageData, ThumbnailWide, ThumbnailTall, Thumbnail);
+
+	OutBlocks.SetNumUninitialized(GetThumbnailBytes());
+	uint8 *pBlock = OutBlocks.GetData();
+	for (int32 y=0; y<ThumbnailTall; y+=4)
+	{
+		for (int32 x=0; x<ThumbnailWide; x+=4)
+		{
+			CompressBlock(Thumbnail.GetData() + y * ThumbnailWide + x, ThumbnailWide, pBlock);
+			pBlock += BlockBytes;
+		}
+	}
+
+	return true;
+}
+
+//=============================================================================================================================
+//
+//=============================================================================================================================
+bool FScreenshotAtlas::Load()
+{
+	Slots.Reset();
+	Blocks.Reset();
+
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *GetAtlasFilename(), FILEREAD_Silent))
+		return false;
+
+	FMemoryReader Reader(FileData);
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	int32 Wide = 0;
+	int32 Tall = 0;
+	Reader << Magic;
+	Reader << Version;
+	Reader << Wide;
+	Reader << Tall;
+
+	//Thumbnails of another size are rebuilt as the saves are saved again
+	if (Magic != AtlasMagic || Version != AtlasVersion || Wide != ThumbnailWide || Tall != ThumbnailTall)
+	{
+		UE_LOG(LogTemp, Display, TEXT("FScreenshotAtlas::Load: Discarding out of date atlas"));
+		return false;
+	}
+
+	Reader << Slots;
+	Reader << Blocks;
+
+	if (Reader.IsError() || Blocks.Num() != Slots.Num() * GetThumbnailBytes())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FScreenshotAtlas::Load: Atlas is corrupted!"));
+		Slots.Reset();
+		Blocks.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+//=============================================================================================================================
+//
+//=============================================================================================================================
+bool FScreenshotAtlas::Save()
+{
+	IFileManager* FileManager = &IFileManager::Get();
+
+	for (int32 i=Slots.Num()-1; i>=0; i--)
+	{
+		const FString SaveFilename = FPaths::ProjectSavedDir() + FString::Printf(TEXT("SaveGames/%s.sav"), *Slots.GetData()[i]);
+		if (!FileManager->FileExists(*SaveFilename))
+		{
+			RemoveAt(i);
+		}
+	}
+
+	TArray<uint8> FileData;
+	FMemoryWriter Writer(FileData);
+
+	uint32 Magic = AtlasMagic;
+	int32 Version = AtlasVersion;
+	int32 Wide = ThumbnailWide;
+	int32 Tall = ThumbnailTall;
+	Writer << Magic;
+	Writer << Version;
+	Writer << Wide;
+	Writer << Tall;
+	Writer << Slots;
+	Writer << Blocks;
+
+	//Written next to it and moved over so the browser never reads half a file
+	const FString Filename = GetAtlasFilename();
+	const FString TempFilename = Filename + TEXT(".tmp");
+	if (!FFileHelper::SaveArrayToFile(FileData, *TempFilename) || !FileManager->Move(*Filename, *TempFilename, true, true))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FScreenshotAtlas::Save: Failed to write \"%s\"!"), *Filename);
+		return false;
+	}
+
+	return true;
+}
+
+//=============================================================================================================================
+//
+//=============================================================================================================================
+void FScreenshotAtlas::SetThumbnail(const FString &InSlot, const TArray<uint8> &InBlocks)
+{
+	const int32 iBytes = GetThumbnailBytes();
+	if (InBlocks.Num() != iBytes)
+		return;
+
+	int32 iIndex = Find(InSlot);
+	if (iIndex == INDEX_NONE)
+	{
+		iIndex = Slots.Add(InSlot);
+		Blocks.AddUninitialized(iBytes);
+	}
+
+	FMemory::Memcpy(Blocks.GetData() + (int64)iIndex * iBytes, InBlocks.GetData(), iBytes);
+}
+
+//=============================================================================================================================
+//
+//=============================================================================================================================
+int32 FScreenshotAtlas::Find(const FString &InSlot) const
+{
+	for (int32 i=0; i<Slots.Num(); i++)
+	{
+		if (Slots.GetData()[i].Equals(InSlot, ESearchCase::IgnoreCase))
+			return i;
+	}
+
+	return INDEX_NONE;
+}
+
+//=============================================================================================================================
+// Last one is moved into the hole so the rest keep their place
+//=============================================================================================================================
+void FScreenshotAtlas::RemoveAt(int32 InIndex)
+{
+	const int32 iBytes = GetThumbnailBytes();
+	const int32 iLast = Slots.Num() - 1;
+	if (InIndex != iLast)
+	{
+		FMemory::Memcpy(Blocks.GetData() + (int64)InIndex * iBytes, Blocks.GetData() + (int64)iLast * iBytes, iBytes);
+	}
+
+	Slots.RemoveAtSwap(InIndex);
+	Blocks.SetNum(iLast * iBytes);
+}
+
+//=============================================================================================================================
+// Thumbnails are in rows of Columns, the blocks are copied as they are
+//=============================================================================================================================
+class UTexture2D *FScreenshotAtlas::CreateTexture() const
+{
+	if (Slots.Num() == 0)
+		return NULL;
+
+	const int32 iRows = (Slots.Num() + Columns - 1) / Columns;
+	const int32 Wide = Columns * ThumbnailWide;
+	const int32 Tall = iRows * ThumbnailTall;
+
+	class UTexture2D *pTexture = UTexture2D::CreateTransient(Wide, Tall, PF_DXT1);
+	if (!pTexture)
+		return NULL;
+
+	const int32 iRowBytes = (ThumbnailWide / 4) * BlockBytes;
+	const int32 iTextureRowBytes = (Wide / 4) * BlockBytes;
+	const int32 iBlockRows = ThumbnailTall / 4;
+	const int32 iBytes = GetThumbnailBytes();
+
+	uint8 *pData = (uint8*)pTexture->GetPlatformData()->Mips[0].BulkData.Lock(LOCK_READ_WRITE);
+	FMemory::Memzero(pData, (int64)iTextureRowBytes * (Tall / 4));
+
+	for (int32 i=0; i<Slots.Num(); i++)
+	{
+		const uint8 *pSource = Blocks.GetData() + (int64)i * iBytes;
+		uint8 *pTarget = pData + (int64)(i / Columns) * iBlockRows * iTextureRowBytes + (i % Columns) * iRowBytes;
+		for (int32 y=0; y<iBlockRows; y++)
+		{
+			FMemory::Memcpy(pTarget + (int64)y * iTextureRowBytes, pSource + y * iRowBytes, iRowBytes);
+		}
+	}
+
+	pTexture->GetPlatformData()->Mips[0].BulkData.Unlock();
+	pTexture->UpdateResource();
+	return pTexture;
+}
+
+//=============================================================================================================================
+//
+//=============================================================================================================================
+FBox2f FScreenshotAtlas::GetRegion(int32 InIndex) const
+{
+	const int32 iRows = (Slots.Num() + Columns - 1) / Columns;
+	const FVector2f Size(1.0f / Columns, 1.0f / FMath::Max(iRows, 1));
+	const FVector2f Min((InIndex % Columns) * Size.X, (InIndex / Columns) * Size.Y);
+	return FBox2f(Min, Min + Size);
+}
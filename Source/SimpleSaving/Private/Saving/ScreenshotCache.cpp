@@ -0,0 +1,99 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#include "Saving/ScreenshotCache.h"
+
+//=============================================================================================================================
+//
+//=============================================================================================================================
+const FScreenshotCache::FEntry *FScreenshotCache::Find(const FString &InSlot, const FDateTime &InDateTime)
+{
+	FEntry *pEntry = Entries.Find(InSlot);
+	if (!pEntry)
+		return NULL;
+
+	//Saved over since
+	if (pEntry->DateTime != InDateTime)
+	{
+		Invalidate(InSlot);
+		return NULL;
+	}
+
+	pEntry->LastUsed = ++Clock;
+	return pEntry;
+}
+
+//=============================================================================================================================
+//
+//=============================================================================================================================
+void FScreenshotCache::Add(const FString &InSlot, const FDateTime &InDateTime, int32 InWide, int32 InTall, const TArray<uint8> &InUncompressedBGRA)
+{
+	if (InUncompressedBGRA.Num() == 0 || InUncompressedBGRA.Num() > Budget)
+		return;
+
+	Invalidate(InSlot);
+
+	FEntry &Entry = Entries.Add(InSlot);
+	Entry.DateTime = InDateTime;
+	Entry.UncompressedBGRA = InUncompressedBGRA;
+	Entry.Wide = InWide;
+	Entry.Tall = InTall;
+	Entry.LastUsed = ++Clock;
+
+	Bytes += Entry.UncompressedBGRA.Num();
+	Trim();
+}
+
+//=============================================================================================================================
+//
+//=============================================================================================================================
+void FScreenshotCache::Invalidate(const FString &InSlot)
+{
+	FEntry Removed;
+	if (Entries.RemoveAndCopyValue(InSlot, Removed))
+	{
+		Bytes -= Removed.UncompressedBGRA.Num();
+	}
+}
+
+//=============================================================================================================================
+//
+//=============================================================================================================================
+void FScreenshotCache::Empty()
+{
+	Entries.Empty();
+	Bytes = 0;
+}
+
+//=============================================================================================================================
+//
+//=============================================================================================================================
+void FScreenshotCache::SetBudget(int64 InBytes)
+{
+	Budget = FMath::Max<int64>(InBytes, 0);
+	Trim();
+}
+
+//=============================================================================================================================
+// There are only as many entries as there are saves, so the
+// oldest one is searched for
+//=============================================================================================================================
+void FScreenshotCache::Trim()
+{
+	while (Bytes > Budget && Entries.Num() > 0)
+	{
+		const FString *pOldest = NULL;
+		uint64 iOldest = MAX_uint64;
+		for (auto It = Entries.CreateConstIterator(); It; ++It)
+		{
+			if (It.Value().LastUsed < iOldest)
+			{
+				pOldest = &It.Key();
+				iOldest = It.Value().LastUsed;
+			}
+		}
+
+		Invalidate(FString(*pOldest));
+	}
+}
@@ -0,0 +1,81 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#include "Saving/ScreenshotDecodeQueue.h"
+#include "IImageWrapperModule.h"
+#include "IImageWrapper.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Async/Async.h"
+
+//=============================================================================================================================
+//
+//=============================================================================================================================
+void FScreenshotDecodeQueue::Decode(int32 InRequestId, const FString &InFilename, TFunction<void()> &&OnDecoded)
+{
+	//Loaded on the game thread, the tasks only use it
+	FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+
+	InFlight++;
+
+	Async(EAsyncExecution::TaskGraph, [Queue = AsShared(), InRequestId, Filename = InFilename, OnDecoded = MoveTemp(OnDecoded)]() mutable
+	{
+		FScreenshotDecodeResult Result;
+		Result.RequestId = InRequestId;
+		LoadScreenshot(Filename, Result);
+
+		Queue->Results.Enqueue(MoveTemp(Result));
+		Queue->InFlight--;
+
+		AsyncTask(ENamedThreads::GameThread, MoveTemp(OnDecoded));
+	});
+}
+
+//=============================================================================================================================
+//
+//=============================================================================================================================
+void FScreenshotDecodeQueue::Finish(FScreenshotDecodeResult &&InResult, TFunction<void()> &&OnDecoded)
+{
+	Results.Enqueue(MoveTemp(InResult));
+	AsyncTask(ENamedThreads::GameThread, MoveTemp(OnDecoded));
+}
+
+//=============================================================================================================================
+//
+//=============================================================================================================================
+bool FScreenshotDecodeQueue::LoadScreenshot(const FString &InFilename, FScreenshotDecodeResult &OutResult)
+{
+	FString ScreenshotFilename = FPaths::ProjectSavedDir() + FString::Printf(TEXT("SaveGames/Header/%s.jpg"), *InFilename);
+
+	IImageWrapperModule& ImageWrapperModule = FModuleManager::GetModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+	TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::JPEG);
+	if (!ImageWrapper.IsValid())
+	{
+		UE_LOG(LogTemp, Error, TEXT("FScreenshotDecodeQueue::LoadScreenshot: Failed to create image wrapped!"));
+		return false;
+	}
+
+	TArray<uint8> RawFileData;
+	if (!FFileHelper::LoadFileToArray(RawFileData, *ScreenshotFilename))
+	{
+		UE_LOG(LogTemp, Error, TEXT("FScreenshotDecodeQueue::LoadScreenshot: Failed to load file \"%s\""), *ScreenshotFilename);
+		return false;
+	}
+
+	if (!ImageWrapper->SetCompressed(RawFileData.GetData(), RawFileData.Num()))
+	{
+		UE_LOG(LogTemp, Error, TEXT("FScreenshotDecodeQueue::LoadScreenshot: Failed to compressed data!"));
+		return false;
+	}
+
+	if (!ImageWrapper->GetRaw(ERGBFormat::BGRA, 8, OutResult.UncompressedBGRA))
+	{
+		UE_LOG(LogTemp, Error, TEXT("FScreenshotDecodeQueue::LoadScreenshot: Failed to get raw data!"));
+		return false;
+	}
+
+	OutResult.Wide = ImageWrapper->GetWidth();
+	OutResult.Tall = ImageWrapper->GetHeight();
+	return true;
+}
@@ -6,6 +6,8 @@
 #include "Saving/ScreenshotLoader.h"
 #include "UMG/Public/Blueprint/UserWidget.h"
 #include "Saving/SimpleSaveFile.h"
+#include "Saving/SaveGameInstance.h"
+#include "Kismet/GameplayStatics.h"
 
 
 //===========================================================================================================================
@@ -15,9 +17,7 @@ UScreenshotLoader::UScreenshotLoader()
 {
 	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
 	// off to improve performance if you don't need them.
-	PrimaryComponentTick.bCanEverTick = true;
-	PrimaryComponentTick.bStartWithTickEnabled = false;
-	PrimaryComponentTick.bTickEvenWhenPaused = true;
+	PrimaryComponentTick.bCanEverTick = false;
 	
 
 	// ...
@@ -31,7 +31,7 @@ void UScreenshotLoader::OnUnregister()
 {
 	Super::OnUnregister();
 
-	DestroyRunnable();
+	DestroyDecodeQueue();
 }
 
 //===========================================================================================================================
@@ -41,7 +41,7 @@ void UScreenshotLoader::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
 
-	DestroyRunnable();
+	DestroyDecodeQueue();
 }
 
 
@@ -59,122 +59,273 @@ void UScreenshotLoader::BeginPlay()
 //===========================================================================================================================
 //
 //===========================================================================================================================
-void UScreenshotLoader::InitRunnable()
+void UScreenshotLoader::InitDecodeQueue()
 {
-	if (!LoaderRunnable)
+	if (!DecodeQueue.IsValid())
 	{
-		LoaderRunnable = new FScreenshotLoaderRunnable();
+		DecodeQueue = MakeShared<FScreenshotDecodeQueue, ESPMode::ThreadSafe>();
 	}
 }
 
 //===========================================================================================================================
 //
 //===========================================================================================================================
-void UScreenshotLoader::DestroyRunnable()
+void UScreenshotLoader::DestroyDecodeQueue()
 {
-	if (LoaderRunnable)
+	//Decodes still running finish on their own and nobody picks up the results
+	DecodeQueue.Reset();
+	Requests.Reset();
+}
+
+//===========================================================================================================================
+// Widgets must still be on screen
+//===========================================================================================================================
+static bool IsRequestOnScreen(const FRequestHeaderScreenshot &InRequest, bool &OutVisible)
+{
+	OutVisible = false;
+
+	if (!IsValid(InRequest.LatentInfo.CallbackTarget))
+		return false;
+
+	class UUserWidget* pWidget = Cast<UUserWidget>(InRequest.LatentInfo.CallbackTarget);
+	if (!pWidget)
 	{
-		LoaderRunnable->EnsureCompletion();
-		delete LoaderRunnable;
-		LoaderRunnable = NULL;
+		OutVisible = true;
+		return true;
 	}
+
+	if (!pWidget->IsInViewport() && !IsValid((class UObject*)pWidget->GetParent()))
+		return false;
+
+	OutVisible = pWidget->IsVisible();
+	return true;
 }
 
 //===========================================================================================================================
 //
 //===========================================================================================================================
-void UScreenshotLoader::HandleReceivedData(int32 Wide, int32 Tall, const TArray<uint8> &UncompressedBGRA)
+void UScreenshotLoader::StartDecodes()
 {
-	if (Wide == 0 || Tall == 0 || UncompressedBGRA.Num() == 0)
-	{
-		UE_LOG(LogTemp, Error, TEXT("UScreenshotLoader::HandleReceivedData: Wide %d Tall %d Data size %d"), Wide, Tall, UncompressedBGRA.Num());
+	if (!DecodeQueue.IsValid())
 		return;
-	}
 
-	//If object no longer exists then don't bother
-	if (!IsValid(Requests.GetData()[0].LatentInfo.CallbackTarget))
+	//Cancel the ones that haven't started yet
+	for (int32 i=Requests.Num()-1; i>=0; i--)
 	{
-		UE_LOG(LogTemp, Error, TEXT("UScreenshotLoader::HandleReceivedData: Latent object no longer exists!"));
-		return;
+		bool bVisible = false;
+		if (Requests.GetData()[i].RequestId == INDEX_NONE && !IsRequestOnScreen(Requests.GetData()[i], bVisible))
+		{
+			UE_LOG(LogTemp, Verbose, TEXT("UScreenshotLoader::StartDecodes: Cancelled \"%s\", no longer on screen"), *Requests.GetData()[i].Filename);
+			Requests.RemoveAt(i);
+		}
 	}
 
-	//Widgets must still be on screen
-	class UUserWidget* pWidget = Cast<UUserWidget>(Requests.GetData()[0].LatentInfo.CallbackTarget);
-	if (pWidget)
+	while (DecodeQueue->GetNumInFlight() < FMath::Max(MaxConcurrentDecodes, 1))
 	{
-		if (!pWidget->IsInViewport() && !IsValid((class UObject*)pWidget->GetParent()))
+		//Visible first, then in the order they were requested
+		int32 iBest = INDEX_NONE;
+		bool bBestVisible = false;
+		for (int32 i=0; i<Requests.Num(); i++)
 		{
-			UE_LOG(LogTemp, Error, TEXT("UScreenshotLoader::HandleReceivedData: Latent object no longer on screen!"));
-			return;
+			if (Requests.GetData()[i].RequestId != INDEX_NONE)
+				continue;
+
+			bool bVisible = false;
+			IsRequestOnScreen(Requests.GetData()[i], bVisible);
+			if (iBest == INDEX_NONE || (bVisible && !bBestVisible))
+			{
+				iBest = i;
+				bBestVisible = bVisible;
+			}
 		}
-	}
 
-	UFunction* pExecutionFunction = Requests.GetData()[0].LatentInfo.CallbackTarget->FindFunction(Requests.GetData()[0].LatentInfo.ExecutionFunction);
-	if (!IsValid(pExecutionFunction))
-	{
-		UE_LOG(LogTemp, Error, TEXT("UScreenshotLoader::HandleReceivedData: Failed to find function %s"), *Requests.GetData()[0].LatentInfo.ExecutionFunction.ToString());
-		return;
+		if (iBest == INDEX_NONE)
+			break;
+
+		FRequestHeaderScreenshot &Request = Requests.GetData()[iBest];
+		Request.RequestId = NextRequestId++;
+
+		DecodeQueue->Decode(Request.RequestId, Request.Filename, MakeDecodedCallback());
 	}
+}
 
-	class UTexture2D* pTexture = NULL;
-	for (int32 i = 0; i < ScreenshotPool.Num(); i++)
+//===========================================================================================================================
+//
+//===========================================================================================================================
+TFunction<void()> UScreenshotLoader::MakeDecodedCallback()
+{
+	TWeakObjectPtr<UScreenshotLoader> WeakLoader(this);
+	return [WeakLoader]()
 	{
-		if (ScreenshotPool.GetData()[i]->GetSizeX() == Wide && ScreenshotPool.GetData()[i]->GetSizeY() == Tall)
+		if (WeakLoader.IsValid())
 		{
-			pTexture =ScreenshotPool.GetData()[i];
-			ScreenshotPool.RemoveAt(i);
-			break;
+			WeakLoader->ProcessDecoded();
 		}
+	};
+}
+
+//===========================================================================================================================
+//
+//===========================================================================================================================
+bool UScreenshotLoader::CompleteFromCache(FRequestHeaderScreenshot &InOutRequest)
+{
+	FScreenshotDecodeResult Result;
+
+	InOutRequest.CachedTexture = TakePooledTexture(InOutRequest.Filename, InOutRequest.DateTime);
+	if (!InOutRequest.CachedTexture)
+	{
+		class USaveGameInstance *pGameInstance = Cast<USaveGameInstance>(UGameplayStatics::GetGameInstance(this));
+		if (!pGameInstance)
+			return false;
+
+		const FScreenshotCache::FEntry *pEntry = pGameInstance->GetScreenshotCache().Find(InOutRequest.Filename, InOutRequest.DateTime);
+		if (!pEntry)
+			return false;
+
+		Result.UncompressedBGRA = pEntry->UncompressedBGRA;
+		Result.Wide = pEntry->Wide;
+		Result.Tall = pEntry->Tall;
+		InOutRequest.bCached = true;
 	}
 
-	//Create new
-	if (!IsValid(pTexture))
+	InOutRequest.RequestId = NextRequestId++;
+	Result.RequestId = InOutRequest.RequestId;
+	DecodeQueue->Finish(MoveTemp(Result), MakeDecodedCallback());
+	return true;
+}
+
+//===========================================================================================================================
+//
+//===========================================================================================================================
+class UTexture2D *UScreenshotLoader::TakePooledTexture(const FString &InFilename, const FDateTime &InDateTime)
+{
+	for (auto It = TextureContents.CreateConstIterator(); It; ++It)
 	{
-		int32 i = Screenshots.Add(UTexture2D::CreateTransient(Wide, Tall, PF_B8G8R8A8));
-		pTexture = Screenshots.GetData()[i];
+		if (It.Value().DateTime != InDateTime || !It.Value().Filename.Equals(InFilename, ESearchCase::IgnoreCase))
+			continue;
+
+		class UTexture2D *pTexture = const_cast<UTexture2D*>(It.Key());
+		TArray<class UTexture2D*> *pPool = ScreenshotPool.Find(FIntPoint(pTexture->GetSizeX(), pTexture->GetSizeY()));
+		if (pPool && pPool->Remove(pTexture) > 0)
+			return pTexture;
 	}
 
-	void* TextureData = pTexture->GetPlatformData()->Mips[0].BulkData.Lock(LOCK_READ_WRITE);
-	FMemory::Memcpy(TextureData, UncompressedBGRA.GetData(), UncompressedBGRA.Num());
-	pTexture->GetPlatformData()->Mips[0].BulkData.Unlock();
+	return NULL;
+}
 
-	// Update the rendering resource from data.
-	pTexture->UpdateResource();
+//===========================================================================================================================
+//
+//===========================================================================================================================
+void UScreenshotLoader::ReturnToPool(class UTexture2D *InTexture)
+{
+	ScreenshotPool.FindOrAdd(FIntPoint(InTexture->GetSizeX(), InTexture->GetSizeY())).AddUnique(InTexture);
+}
 
-	*Requests.GetData()[0].TexturePointer = pTexture;
-	Requests.GetData()[0].LatentInfo.CallbackTarget->ProcessEvent(pExecutionFunction, &Requests.GetData()[0].LatentInfo.Linkage);
+//===========================================================================================================================
+//
+//===========================================================================================================================
+void UScreenshotLoader::ProcessDecoded()
+{
+	if (!DecodeQueue.IsValid())
+		return;
 
-	UE_LOG(LogTemp, Display, TEXT("UScreenshotLoader::HandleReceivedData: Success!"));
+	FScreenshotDecodeResult Result;
+	while (DecodeQueue->Dequeue(Result))
+	{
+		for (int32 i=0; i<Requests.Num(); i++)
+		{
+			if (Requests.GetData()[i].RequestId != Result.RequestId)
+				continue;
+
+			FRequestHeaderScreenshot Request = Requests.GetData()[i];
+			Requests.RemoveAt(i);
+
+			//Kept for the next time the menu is opened
+			class USaveGameInstance *pGameInstance = Cast<USaveGameInstance>(UGameplayStatics::GetGameInstance(this));
+			if (pGameInstance && !Request.bCached && !Request.CachedTexture)
+			{
+				pGameInstance->GetScreenshotCache().Add(Request.Filename, Request.DateTime, Result.Wide, Result.Tall, Result.UncompressedBGRA);
+			}
+
+			HandleReceivedData(Request, Result);
+			break;
+		}
+	}
+
+	StartDecodes();
 }
 
 //===========================================================================================================================
 //
 //===========================================================================================================================
-void UScreenshotLoader::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+void UScreenshotLoader::HandleReceivedData(const FRequestHeaderScreenshot &InRequest, const FScreenshotDecodeResult &InResult)
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	const int32 Wide = InResult.Wide;
+	const int32 Tall = InResult.Tall;
+	const TArray<uint8> &UncompressedBGRA = InResult.UncompressedBGRA;
 
-	// ...
-	if (LoaderRunnable && LoaderRunnable->CanAddInput())
+	if (!InRequest.CachedTexture && (Wide == 0 || Tall == 0 || UncompressedBGRA.Num() == 0))
 	{
-		if (bStartedLoading)
+		UE_LOG(LogTemp, Error, TEXT("UScreenshotLoader::HandleReceivedData: Wide %d Tall %d Data size %d"), Wide, Tall, UncompressedBGRA.Num());
+		return;
+	}
+
+	//If object no longer exists or left the screen then don't bother
+	bool bVisible = false;
+	if (!IsRequestOnScreen(InRequest, bVisible))
+	{
+		UE_LOG(LogTemp, Error, TEXT("UScreenshotLoader::HandleReceivedData: Latent object no longer on screen!"));
+		if (InRequest.CachedTexture)
 		{
-			HandleReceivedData(LoaderRunnable->Output_Wide, LoaderRunnable->Output_Tall, LoaderRunnable->Output_UncompressedBGRA);
+			ReturnToPool(InRequest.CachedTexture);
+		}
+		return;
+	}
 
-			Requests.RemoveAt(0);
+	UFunction* pExecutionFunction = InRequest.LatentInfo.CallbackTarget->FindFunction(InRequest.LatentInfo.ExecutionFunction);
+	if (!IsValid(pExecutionFunction))
+	{
+		UE_LOG(LogTemp, Error, TEXT("UScreenshotLoader::HandleReceivedData: Failed to find function %s"), *InRequest.LatentInfo.ExecutionFunction.ToString());
+		if (InRequest.CachedTexture)
+		{
+			ReturnToPool(InRequest.CachedTexture);
 		}
+		return;
+	}
 
-		if (Requests.Num() == 0)
+	//Still has the pixels
+	class UTexture2D* pTexture = InRequest.CachedTexture;
+	if (!pTexture)
+	{
+		TArray<class UTexture2D*> *pPool = ScreenshotPool.Find(FIntPoint(Wide, Tall));
+		if (pPool && pPool->Num() > 0)
 		{
-			PrimaryComponentTick.SetTickFunctionEnable(false);
-			bStartedLoading = false;
+			pTexture = pPool->Pop(false);
 		}
-		else
+
+		//Create new
+		if (!IsValid(pTexture))
 		{
-			bStartedLoading = true;
-			LoaderRunnable->SetLoadScreenshot(Requests.GetData()[0].Filename);
+			int32 i = Screenshots.Add(UTexture2D::CreateTransient(Wide, Tall, PF_B8G8R8A8));
+			pTexture = Screenshots.GetData()[i];
 		}
+
+		void* TextureData = pTexture->GetPlatformData()->Mips[0].BulkData.Lock(LOCK_READ_WRITE);
+		FMemory::Memcpy(TextureData, UncompressedBGRA.GetData(), UncompressedBGRA.Num());
+		pTexture->GetPlatformData()->Mips[0].BulkData.Unlock();
+
+		// Update the rendering resource from data.
+		pTexture->UpdateResource();
+
+		FScreenshotTextureContents &Contents = TextureContents.FindOrAdd(pTexture);
+		Contents.Filename = InRequest.Filename;
+		Contents.DateTime = InRequest.DateTime;
 	}
+
+	*InRequest.TexturePointer = pTexture;
+	InRequest.LatentInfo.CallbackTarget->ProcessEvent(pExecutionFunction, (void*)&InRequest.LatentInfo.Linkage);
+
+	UE_LOG(LogTemp, Display, TEXT("UScreenshotLoader::HandleReceivedData: Success!"));
 }
 
 //=================================================================
@@ -201,13 +352,21 @@ void UScreenshotLoader::RequestScreenshot(const class UObject* WorldContext, con
 		return;
 	}
 
+	class USaveGameInstance *pGameInstance = Cast<USaveGameInstance>(UGameplayStatics::GetGameInstance(WorldContext));
+
 	FRequestHeaderScreenshot Request;
 	Request.Filename = Filename;
 	Request.LatentInfo = LatentInfo;
 	Request.TexturePointer = &Screenshot;
-	pScreenshotLoader->Requests.Add(Request);
-	pScreenshotLoader->PrimaryComponentTick.SetTickFunctionEnable(true);
-	pScreenshotLoader->InitRunnable();
+	Request.DateTime = pGameInstance ? pGameInstance->GetSaveFileTime(Filename) : FDateTime::MinValue();
+
+	pScreenshotLoader->InitDecodeQueue();
+
+	int32 iRequest = pScreenshotLoader->Requests.Add(Request);
+	if (!pScreenshotLoader->CompleteFromCache(pScreenshotLoader->Requests.GetData()[iRequest]))
+	{
+		pScreenshotLoader->StartDecodes();
+	}
 }
 
 //=================================================================
@@ -221,6 +380,45 @@ void UScreenshotLoader::FreeScreenshot(const class UObject* WorldContext, class
 	class UScreenshotLoader *pScreenshotLoader = UScreenshotLoader::GetScreenshotLoader(WorldContext);
 	if (pScreenshotLoader && pScreenshotLoader->Screenshots.Contains(Texture))
 	{
-		pScreenshotLoader->ScreenshotPool.AddUnique(Texture);
+		pScreenshotLoader->ReturnToPool(Texture);
+	}
+}
+
+//=================================================================
+// 
+//=================================================================
+void UScreenshotLoader::UpdateAtlas()
+{
+	class USaveGameInstance *pGameInstance = Cast<USaveGameInstance>(UGameplayStatics::GetGameInstance(this));
+	const int32 iVersion = pGameInstance ? pGameInstance->GetScreenshotAtlasVersion() : 0;
+	if (iVersion == AtlasVersion)
+		return;
+
+	AtlasVersion = iVersion;
+	Atlas.Load();
+	AtlasTexture = Atlas.CreateTexture();
+}
+
+//=================================================================
+// 
+//=================================================================
+bool UScreenshotLoader::GetAtlasThumbnail(const class UObject* WorldContext, const FString& Filename, FSlateBrush& Brush)
+{
+	class UScreenshotLoader* pScreenshotLoader = UScreenshotLoader::GetScreenshotLoader(WorldContext);
+	if (!IsValid(pScreenshotLoader))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Add UScreenshotLoader component to your PlayerController!"));
+		return false;
 	}
+
+	pScreenshotLoader->UpdateAtlas();
+
+	const int32 iIndex = pScreenshotLoader->Atlas.Find(Filename);
+	if (iIndex == INDEX_NONE || !pScreenshotLoader->AtlasTexture)
+		return false;
+
+	Brush.SetResourceObject(pScreenshotLoader->AtlasTexture);
+	Brush.SetUVRegion(pScreenshotLoader->Atlas.GetRegion(iIndex));
+	Brush.SetImageSize(FVector2D(FScreenshotAtlas::ThumbnailWide, FScreenshotAtlas::ThumbnailTall));
+	return true;
 }
@@ -0,0 +1,513 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#include "Saving/SimpleRewindBuffer.h"
+#include "Saving/SimpleSaveFile.h"
+#include "Saving/SaveGameInstance.h"
+#include "Kismet/GameplayStatics.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+
+//=================================================================
+// Records are stored with their values so they don't depend on the 
+// shared payloads of the snapshot they were captured in
+//=================================================================
+FORCEINLINE static void InlinePayload(FCustomSaveData &InOutData, const TArray<FSimpleSaveData> &InGlobal, const TArray<FSimpleSaveData> &InLevel)
+{
+	if (InOutData.PayloadIndex == INDEX_NONE)
+		return;
+
+	const TArray<FSimpleSaveData> &Payloads = InOutData.PayloadIsGlobal ? InGlobal : InLevel;
+	InOutData.Singles = InOutData.GetSingles(Payloads);
+	InOutData.Arrays = InOutData.GetArrays(Payloads);
+	InOutData.Maps = InOutData.GetMaps(Payloads);
+	InOutData.PayloadIndex = INDEX_NONE;
+	InOutData.PayloadIsGlobal = false;
+}
+
+//=================================================================
+// 
+//=================================================================
+FORCEINLINE static bool HasPayload(const FActorSaveData &InData)
+{
+	if (InData.Custom.PayloadIndex != INDEX_NONE)
+		return true;
+
+	for (int32 i=0; i<InData.Components.Num(); i++)
+	{
+		if (InData.Components.GetData()[i].Custom.PayloadIndex != INDEX_NONE)
+			return true;
+	}
+
+	return false;
+}
+
+//=================================================================
+// 
+//=================================================================
+FORCEINLINE static int64 GetRecordOverhead(int32 InCount)
+{
+	return (int64)InCount * (sizeof(int32) + sizeof(FSimpleRewindRecordPtr));
+}
+
+//=================================================================
+// 
+//=================================================================
+class FSimpleRewindCapture
+{
+public:
+
+	//
+	FSimpleRewindCapture(const TArray<FSimpleRewindRecordPtr> &InLastRecords, FSimpleRewindSnapshot &InSnapshot)
+		: LastRecords(InLastRecords), Snapshot(InSnapshot)
+	{
+		Records.Reserve(LastRecords.Num());
+		LastByHash.Reserve(LastRecords.Num());
+		for (int32 i=0; i<LastRecords.Num(); i++)
+		{
+			LastByHash.Add(LastRecords.GetData()[i]->Hash, i);
+		}
+	}
+
+	//
+	void AddRecord(const class UScriptStruct *InStruct, const void *InData)
+	{
+		TSharedRef<FSimpleRewindRecord, ESPMode::ThreadSafe> Record = MakeShared<FSimpleRewindRecord, ESPMode::ThreadSafe>();
+
+		FMemoryWriter Writer(Record->Data, true);
+		FObjectAndNameAsStringProxyArchive Archive(Writer, false);
+		InStruct->SerializeItem(Archive, const_cast<void*>(InData), NULL);
+		Record->Hash = FCrc::MemCrc32(Record->Data.GetData(), Record->Data.Num());
+
+		//Unchanged
+		const int32 iIndex = Records.Num();
+		if (LastRecords.IsValidIndex(iIndex) && LastRecords.GetData()[iIndex]->Equals(*Record))
+		{
+			Records.Add(LastRecords.GetData()[iIndex]);
+			return;
+		}
+
+		//Changed, but might still be the same as some other record was
+		FSimpleRewindRecordPtr Shared;
+		const int32 *pLast = LastByHash.Find(Record->Hash);
+		if (pLast && LastRecords.GetData()[*pLast]->Equals(*Record))
+		{
+			Shared = LastRecords.GetData()[*pLast];
+		}
+		else
+		{
+			Record->Data.Shrink();
+			Snapshot.Bytes += Record->Data.Num();
+			Shared = Record;
+		}
+
+		Snapshot.ChangedIndices.Add(iIndex);
+		Snapshot.Changed.Add(Shared);
+		Records.Add(Shared);
+	}
+
+	//
+	void AddActor(const FActorSaveData &InData, const TArray<FSimpleSaveData> &InGlobal, const TArray<FSimpleSaveData> &InLevel)
+	{
+		if (!HasPayload(InData))
+		{
+			AddRecord(FActorSaveData::StaticStruct(), &InData);
+			return;
+		}
+
+		FActorSaveData Data = InData;
+		InlinePayload(Data.Custom, InGlobal, InLevel);
+		for (int32 i=0; i<Data.Components.Num(); i++)
+		{
+			InlinePayload(Data.Components.GetData()[i].Custom, InGlobal, InLevel);
+		}
+
+		AddRecord(FActorSaveData::StaticStruct(), &Data);
+	}
+
+	//
+	void AddObject(const FCustomSaveData &InData, const TArray<FSimpleSaveData> &InGlobal, const TArray<FSimpleSaveData> &InLevel)
+	{
+		if (InData.PayloadIndex == INDEX_NONE)
+		{
+			AddRecord(FCustomSaveData::StaticStruct(), &InData);
+			return;
+		}
+
+		FCustomSaveData Data = InData;
+		InlinePayload(Data, InGlobal, InLevel);
+		AddRecord(FCustomSaveData::StaticStruct(), &Data);
+	}
+
+public:
+
+	//
+	TArray<FSimpleRewindRecordPtr> Records;
+
+private:
+
+	//
+	const TArray<FSimpleRewindRecordPtr> &LastRecords;
+
+	//
+	FSimpleRewindSnapshot &Snapshot;
+
+	//First record of the previous snapshot with the hash
+	TMap<uint32, int32> LastByHash;
+};
+
+//=================================================================
+// 
+//=================================================================
+bool USimpleRewindBuffer::Capture(const class UObject *WorldContext)
+{
+	class USaveGameInstance *pGameInstance = Cast<USaveGameInstance>(UGameplayStatics::GetGameInstance(WorldContext));
+	if (!pGameInstance || pGameInstance->IsLoading() || pGameInstance->InLevelChange())
+		return false;
+
+	class USimpleSaveFile *pFile = USimpleSaveFile::SaveForRestore(WorldContext);
+	if (!pFile)
+		return false;
+
+	pFile->WaitForLevelPacking();
+
+	FSimpleRewindSnapshot Snapshot;
+	Snapshot.Time = pGameInstance->GetTotalTime(WorldContext);
+
+	//The records are taken out of the save file while the rest of it is written as the header
+	TArray<FActorSaveData> GlobalActors = MoveTemp(pFile->GlobalActors);
+	TArray<FCustomSaveData> GlobalObjects = MoveTemp(pFile->CustomObjects);
+	TArray<FSimpleSaveData> GlobalPayloads = MoveTemp(pFile->SharedPayloads);
+	TArray<FLevelSaveData> Levels = MoveTemp(pFile->Levels);
+
+	const bool bHeader = UGameplayStatics::SaveGameToMemory(pFile, Snapshot.Header);
+
+	Snapshot.Layout.Reserve(3 + Levels.Num() * 2);
+	Snapshot.Layout.Add(GlobalActors.Num());
+	Snapshot.Layout.Add(GlobalObjects.Num());
+	Snapshot.Layout.Add(Levels.Num());
+
+	FSimpleRewindCapture Gather(LastRecords, Snapshot);
+
+	for (int32 i=0; i<GlobalActors.Num(); i++)
+	{
+		Gather.AddActor(GlobalActors.GetData()[i], GlobalPayloads, GlobalPayloads);
+	}
+
+	for (int32 i=0; i<GlobalObjects.Num(); i++)
+	{
+		Gather.AddObject(GlobalObjects.GetData()[i], GlobalPayloads, GlobalPayloads);
+	}
+
+	for (int32 i=0; i<Levels.Num(); i++)
+	{
+		FLevelSaveData &Level = Levels.GetData()[i];
+		Snapshot.Layout.Add(Level.Actors.Num());
+		Snapshot.Layout.Add(Level.CustomObjects.Num());
+
+		//Packed levels keep their payloads, the others are inlined into the records
+		TArray<FActorSaveData> Actors = MoveTemp(Level.Actors);
+		TArray<FCustomSaveData> Objects = MoveTemp(Level.CustomObjects);
+		TArray<FSimpleSaveData> Payloads;
+		if (!Level.IsPacked())
+		{
+			Payloads = MoveTemp(Level.SharedPayloads);
+		}
+
+		Gather.AddRecord(FLevelSaveData::StaticStruct(), &Level);
+
+		for (int32 j=0; j<Actors.Num(); j++)
+		{
+			Gather.AddActor(Actors.GetData()[j], GlobalPayloads, Payloads);
+		}
+
+		for (int32 j=0; j<Objects.Num(); j++)
+		{
+			Gather.AddObject(Objects.GetData()[j], GlobalPayloads, Payloads);
+		}
+
+		Level.Actors = MoveTemp(Actors);
+		Level.CustomObjects = MoveTemp(Objects);
+		if (!Level.IsPacked())
+		{
+			Level.SharedPayloads = MoveTemp(Payloads);
+		}
+	}
+
+	pFile->GlobalActors = MoveTemp(GlobalActors);
+	pFile->CustomObjects = MoveTemp(GlobalObjects);
+	pFile->SharedPayloads = MoveTemp(GlobalPayloads);
+	pFile->Levels = MoveTemp(Levels);
+
+	//Each record was gathered on its own, only now the levels can be packed
+	pFile->StartPackingLevels();
+
+	if (!bHeader)
+	{
+		UE_LOG(LogTemp, Error, TEXT("USimpleRewindBuffer::Capture: Failed to serialize save game!"));
+		return false;
+	}
+
+	Snapshot.NumRecords = Gather.Records.Num();
+	Snapshot.Bytes += Snapshot.Header.Num() + GetRecordOverhead(Snapshot.ChangedIndices.Num());
+
+	TotalBytes += Snapshot.Bytes;
+	Snapshots.Add(MoveTemp(Snapshot));
+	LastRecords = MoveTemp(Gather.Records);
+
+	const int64 iBudget = (int64)MemoryBudgetKilobytes * 1024;
+	while (Snapshots.Num() > 1 && (Snapshots.Num() > MaxSnapshots || TotalBytes > iBudget))
+	{
+		FoldOldest();
+	}
+
+	return true;
+}
+
+//=================================================================
+// 
+//=================================================================
+bool USimpleRewindBuffer::Rewind(const class UObject *WorldContext, float Seconds)
+{
+	if (Snapshots.Num() == 0)
+		return false;
+
+	class USaveGameInstance *pGameInstance = Cast<USaveGameInstance>(UGameplayStatics::GetGameInstance(WorldContext));
+	if (!pGameInstance)
+		return false;
+
+	const float fTarget = pGameInstance->GetTotalTime(WorldContext) - Seconds;
+
+	int32 iSnapshot = 0;
+	for (int32 i=Snapshots.Num()-1; i>=0; i--)
+	{
+		if (Snapshots.GetData()[i].Time <= fTarget)
+		{
+			iSnapshot = i;
+			break;
+		}
+	}
+
+	class USimpleSaveFile *pFile = BuildSaveFile(iSnapshot);
+	if (!pFile)
+		return false;
+
+	if (!USimpleSaveFile::RestoreSaveFile(WorldContext, pFile, pGameInstance->UseInPlaceCheckpoints()))
+		return false;
+
+	//Snapshots after it are of what no longer happened
+	for (int32 i=Snapshots.Num()-1; i>iSnapshot; i--)
+	{
+		TotalBytes -= Snapshots.GetData()[i].Bytes;
+	}
+
+	Snapshots.SetNum(iSnapshot + 1);
+	BuildRecords(iSnapshot, LastRecords);
+	return true;
+}
+
+//=================================================================
+// 
+//=================================================================
+void USimpleRewindBuffer::StartCapturing(const class UObject *WorldContext)
+{
+	class UWorld *pWorld = IsValid(WorldContext) ? WorldContext->GetWorld() : NULL;
+	if (!pWorld)
+		return;
+
+	CaptureContext = WorldContext;
+	pWorld->GetTimerManager().SetTimer(CaptureTimer, FTimerDelegate::CreateUObject(this, &USimpleRewindBuffer::CaptureFromTimer), FMath::Max(CaptureInterval, 0.1f), true);
+}
+
+//=================================================================
+// 
+//=================================================================
+void USimpleRewindBuffer::StopCapturing(const class UObject *WorldContext)
+{
+	class UWorld *pWorld = IsValid(WorldContext) ? WorldContext->GetWorld() : NULL;
+	if (pWorld)
+	{
+		pWorld->GetTimerManager().ClearTimer(CaptureTimer);
+	}
+
+	CaptureContext = NULL;
+}
+
+//=================================================================
+// 
+//=================================================================
+void USimpleRewindBuffer::CaptureFromTimer()
+{
+	if (CaptureContext.IsValid())
+	{
+		Capture(CaptureContext.Get());
+	}
+}
+
+//=================================================================
+// 
+//=================================================================
+void USimpleRewindBuffer::Clear()
+{
+	Snapshots.Empty();
+	LastRecords.Empty();
+	TotalBytes = 0;
+}
+
+//=================================================================
+// 
+//=================================================================
+float USimpleRewindBuffer::GetOldestTime() const
+{
+	return Snapshots.Num() > 0 ? Snapshots.GetData()[0].Time : 0.0f;
+}
+
+//=================================================================
+// The delta after the keyframe becomes the new keyframe, records 
+// only the old keyframe used are released
+//=================================================================
+void USimpleRewindBuffer::FoldOldest()
+{
+	if (Snapshots.Num() < 2)
+		return;
+
+	TArray<FSimpleRewindRecordPtr> Records;
+	BuildRecords(1, Records);
+
+	TotalBytes -= Snapshots.GetData()[0].Bytes + Snapshots.GetData()[1].Bytes;
+
+	FSimpleRewindSnapshot &Next = Snapshots.GetData()[1];
+	Next.ChangedIndices.SetNumUninitialized(Records.Num());
+	for (int32 i=0; i<Records.Num(); i++)
+	{
+		Next.ChangedIndices.GetData()[i] = i;
+	}
+
+	Next.Bytes = Next.Header.Num() + GetUniqueBytes(Records) + GetRecordOverhead(Records.Num());
+	Next.Changed = MoveTemp(Records);
+
+	Snapshots.RemoveAt(0);
+	TotalBytes += Snapshots.GetData()[0].Bytes;
+}
+
+//=================================================================
+// 
+//=================================================================
+void USimpleRewindBuffer::BuildRecords(int32 InSnapshot, TArray<FSimpleRewindRecordPtr> &OutRecords) const
+{
+	OutRecords.Reset();
+
+	for (int32 i=0; i<=InSnapshot && i<Snapshots.Num(); i++)
+	{
+		const FSimpleRewindSnapshot &Snapshot = Snapshots.GetData()[i];
+		OutRecords.SetNum(Snapshot.NumRecords);
+
+		for (int32 j=0; j<Snapshot.ChangedIndices.Num(); j++)
+		{
+			OutRecords.GetData()[Snapshot.ChangedIndices.GetData()[j]] = Snapshot.Changed.GetData()[j];
+		}
+	}
+}
+
+//=================================================================
+// 
+//=================================================================
+class USimpleSaveFile *USimpleRewindBuffer::BuildSaveFile(int32 InSnapshot) const
+{
+	if (!Snapshots.IsValidIndex(InSnapshot))
+		return NULL;
+
+	const FSimpleRewindSnapshot &Snapshot = Snapshots.GetData()[InSnapshot];
+
+	TArray<FSimpleRewindRecordPtr> Records;
+	BuildRecords(InSnapshot, Records);
+
+	class USimpleSaveFile *pFile = Cast<USimpleSaveFile>(UGameplayStatics::LoadGameFromMemory(Snapshot.Header));
+	if (!pFile || Snapshot.Layout.Num() < 3)
+	{
+		UE_LOG(LogTemp, Error, TEXT("USimpleRewindBuffer::BuildSaveFile: Failed to read snapshot!"));
+		return NULL;
+	}
+
+	int32 iRecord = 0;
+	auto ReadRecord = [&Records, &iRecord](const class UScriptStruct *InStruct, void *OutData) -> bool
+	{
+		if (!Records.IsValidIndex(iRecord) || !Records.GetData()[iRecord].IsValid())
+			return false;
+
+		FMemoryReader Reader(Records.GetData()[iRecord]->Data, true);
+		FObjectAndNameAsStringProxyArchive Archive(Reader, false);
+		InStruct->SerializeItem(Archive, OutData, NULL);
+		iRecord++;
+		return true;
+	};
+
+	bool bValid = true;
+
+	pFile->GlobalActors.SetNum(Snapshot.Layout.GetData()[0]);
+	for (int32 i=0; i<pFile->GlobalActors.Num(); i++)
+	{
+		bValid &= ReadRecord(FActorSaveData::StaticStruct(), &pFile->GlobalActors.GetData()[i]);
+	}
+
+	pFile->CustomObjects.SetNum(Snapshot.Layout.GetData()[1]);
+	for (int32 i=0; i<pFile->CustomObjects.Num(); i++)
+	{
+		bValid &= ReadRecord(FCustomSaveData::StaticStruct(), &pFile->CustomObjects.GetData()[i]);
+	}
+
+	pFile->Levels.SetNum(Snapshot.Layout.GetData()[2]);
+	bValid &= Snapshot.Layout.Num() == 3 + pFile->Levels.Num() * 2;
+
+	for (int32 i=0; bValid && i<pFile->Levels.Num(); i++)
+	{
+		FLevelSaveData &Level = pFile->Levels.GetData()[i];
+		bValid &= ReadRecord(FLevelSaveData::StaticStruct(), &Level);
+
+		Level.Actors.SetNum(Snapshot.Layout.GetData()[3 + i * 2]);
+		for (int32 j=0; j<Level.Actors.Num(); j++)
+		{
+			bValid &= ReadRecord(FActorSaveData::StaticStruct(), &Level.Actors.GetData()[j]);
+		}
+
+		Level.CustomObjects.SetNum(Snapshot.Layout.GetData()[4 + i * 2]);
+		for (int32 j=0; j<Level.CustomObjects.Num(); j++)
+		{
+			bValid &= ReadRecord(FCustomSaveData::StaticStruct(), &Level.CustomObjects.GetData()[j]);
+		}
+	}
+
+	if (!bValid || iRecord != Records.Num())
+	{
+		UE_LOG(LogTemp, Error, TEXT("USimpleRewindBuffer::BuildSaveFile: Records don't match the layout of the snapshot!"));
+		return NULL;
+	}
+
+	return pFile;
+}
+
+//=================================================================
+// 
+//=================================================================
+int64 USimpleRewindBuffer::GetUniqueBytes(const TArray<FSimpleRewindRecordPtr> &InRecords)
+{
+	TSet<const FSimpleRewindRecord*> Seen;
+	Seen.Reserve(InRecords.Num());
+
+	int64 iBytes = 0;
+	for (int32 i=0; i<InRecords.Num(); i++)
+	{
+		bool bAlreadySeen = false;
+		Seen.Add(InRecords.GetData()[i].Get(), &bAlreadySeen);
+		if (!bAlreadySeen)
+		{
+			iBytes += InRecords.GetData()[i]->Data.Num();
+		}
+	}
+
+	return iBytes;
+}
@@ -28,6 +28,9 @@
 #include "Components/DrawFrustumComponent.h"
 #include "Saving/SimpleRestoreHandler.h"
 #include "Components/TimelineComponent.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Saving/SimpleSavePrefetch.h"
 
 #if WITH_EDITOR
 static bool g_bIsUsingDataPointer = false;
@@ -45,6 +48,7 @@ int32 _GetObjectsDataSize(const FCustomSaveData &InData)
 	iTotal += InData.Class.ToString().GetAllocatedSize() + sizeof(int32);
 	iTotal += InData.Name.ToString().GetAllocatedSize() + sizeof(int32);
 	iTotal += InData.Tag.ToString().GetAllocatedSize() + sizeof(int32);
+	iTotal += InData.ParentTag.ToString().GetAllocatedSize() + sizeof(int32);
 	iTotal += sizeof(int32) * 2 + sizeof(bool) * 2;
 
 	return iTotal;
@@ -64,6 +68,20 @@ int32 _GetTotalObjectsDataSize(const TArray<FCustomSaveData>& InObjectsData)
 	return iTotal;
 }
 
+//=================================================================
+// 
+//=================================================================
+int32 _GetPayloadsDataSize(const TArray<FSimpleSaveData> &InPayloads)
+{
+	int32 iTotal = sizeof(int32);
+	for (int32 i=0; i<InPayloads.Num(); i++)
+	{
+		iTotal += FCustomSaveData::_CalculateBytes(InPayloads.GetData()[i].Singles, InPayloads.GetData()[i].Arrays, InPayloads.GetData()[i].Maps);
+	}
+
+	return iTotal;
+}
+
 //=================================================================
 // 
 //=================================================================
@@ -104,14 +122,31 @@ int32 _GetTotalActorDataSize(const TArray<FActorSaveData>& InActorsData)
 //=================================================================
 // 
 //=================================================================
-FString USimpleSaveFile::GetLevelSizeString(int32 InLevel) const
+int32 _GetLevelDataSize(const FLevelSaveData &InData)
+{
+	int32 iTotal = InData.LevelName.ToString().GetAllocatedSize() + sizeof(float);
+
+	if (InData.IsPacked())
+	{
+		return iTotal + InData.PackedData.GetAllocatedSize() + InData.PackedOffsets.GetAllocatedSize() + sizeof(int32) + _GetPayloadsDataSize(InData.SharedPayloads);
+	}
+
+	return iTotal + _GetTotalActorDataSize(InData.Actors) + _GetTotalObjectsDataSize(InData.CustomObjects) + _GetPayloadsDataSize(InData.SharedPayloads);
+}
+
+//=================================================================
+// 
+//=================================================================
+FString USimpleSaveFile::GetLevelSizeString(int32 InLevel)
 {
+	WaitForLevelPacking();
+
 	if (!Levels.IsValidIndex(InLevel))
 		return TEXT("Invalid");
 
 	const FLevelSaveData &Data = Levels.GetData()[InLevel];
 
-	int32 iTotal = _GetTotalActorDataSize(Data.Actors) + _GetTotalObjectsDataSize(Data.CustomObjects) + Data.LevelName.ToString().GetAllocatedSize() + sizeof(float);
+	int32 iTotal = _GetLevelDataSize(Data);
 
 	int32 Bytes;
 	int32 Kilybytes;
@@ -128,7 +163,7 @@ FString USimpleSaveFile::GetLevelSizeString(int32 InLevel) const
 //=================================================================
 FString USimpleSaveFile::GetGlobalSizeString() const
 {
-	int32 iTotal = _GetTotalActorDataSize(GlobalActors) + _GetTotalObjectsDataSize(CustomObjects);
+	int32 iTotal = _GetTotalActorDataSize(GlobalActors) + _GetTotalObjectsDataSize(CustomObjects) + _GetPayloadsDataSize(SharedPayloads);
 
 	int32 Bytes;
 	int32 Kilybytes;
@@ -143,14 +178,15 @@ FString USimpleSaveFile::GetGlobalSizeString() const
 //=================================================================
 // 
 //=================================================================
-FString USimpleSaveFile::GetTotalSizeString() const
+FString USimpleSaveFile::GetTotalSizeString()
 {
-	int32 iTotal = _GetTotalActorDataSize(GlobalActors) + _GetTotalObjectsDataSize(CustomObjects);
+	WaitForLevelPacking();
+
+	int32 iTotal = _GetTotalActorDataSize(GlobalActors) + _GetTotalObjectsDataSize(CustomObjects) + _GetPayloadsDataSize(SharedPayloads);
 
 	for (int32 i=0; i<Levels.Num(); i++)
 	{
-		const FLevelSaveData& Data = Levels.GetData()[i];
-		iTotal += _GetTotalActorDataSize(Data.Actors) + _GetTotalObjectsDataSize(Data.CustomObjects) + Data.LevelName.ToString().GetAllocatedSize() + sizeof(float);
+		iTotal += _GetLevelDataSize(Levels.GetData()[i]);
 	}
 
 	int32 Bytes;
@@ -250,6 +286,14 @@ FORCEINLINE static void AddClassFromCustomData(const FCustomSaveData& InData, TA
 // 
 //=================================================================
 bool USimpleSaveFile::GatherClassesToLoad(class UObject *WorldContext, TArray<class TSoftClassPtr<class UObject>> &OutClasses)
+{
+	return GatherClassesForMap(*UGameplayStatics::GetCurrentLevelName(WorldContext), OutClasses);
+}
+
+//=================================================================
+// 
+//=================================================================
+bool USimpleSaveFile::GatherClassesForMap(const FName &InMapName, TArray<class TSoftClassPtr<class UObject>> &OutClasses)
 {
 	if (GatheredClasses.Num() > 0)
 	{
@@ -277,19 +321,8 @@ bool USimpleSaveFile::GatherClassesToLoad(class UObject *WorldContext, TArray<cl
 		AddClassFromCustomData(CustomObjects.GetData()[i], OutClasses);
 	}
 
-
-	FName MapName = *UGameplayStatics::GetCurrentLevelName(WorldContext);
-
 	//Find level data
-	FLevelSaveData *pLevelData = NULL;
-	for (int32 i=0; i<Levels.Num(); i++)
-	{
-		if (Levels.GetData()[i].LevelName == MapName)
-		{
-			pLevelData = &Levels.GetData()[i];
-			break;
-		}
-	}
+	FLevelSaveData *pLevelData = FindLevelData(InMapName);
 
 	if (pLevelData != NULL)
 	{
@@ -369,7 +402,11 @@ bool USimpleSaveFile::CopySaveFile(const class UObject *WorldContext, FString So
 	}
 
 	//
-	if (UGameplayStatics::SaveGameToSlot(pLoadGame, Destination, 0))
+	pGameInstance->GetSavePrefetch()->BeginWrite(Destination);
+	const bool bSaved = UGameplayStatics::SaveGameToSlot(pLoadGame, Destination, 0);
+	pGameInstance->GetSavePrefetch()->EndWrite(Destination);
+
+	if (bSaved)
 	{
 		USimpleSaveHeader::CopyHeaderData(WorldContext, Source, Destination);
 
@@ -426,8 +463,22 @@ bool USimpleSaveFile::SaveGame(const class UObject *WorldContext, FString Filena
 		return false;
 	}
 
+	//Nothing is written on level change, the level being left is packed while the next one loads
+	if (InChangeLevel)
+	{
+		pGameInstance->GetLoadGame()->StartPackingLevels();
+		return true;
+	}
+
 	//
-	if (!InChangeLevel && UGameplayStatics::SaveGameToSlot(pGameInstance->GetLoadGame(), Filename, 0))
+	pGameInstance->GetSavePrefetch()->BeginWrite(Filename);
+	const bool bSaved = UGameplayStatics::SaveGameToSlot(pGameInstance->GetLoadGame(), Filename, 0);
+	pGameInstance->GetSavePrefetch()->EndWrite(Filename);
+
+	//Records are only packed once written, the file gets them as they were saved
+	pGameInstance->GetLoadGame()->StartPackingLevels();
+
+	if (bSaved)
 	{
 		USimpleSaveHeader::SaveHeaderDataFor(WorldContext, Filename);
 
@@ -435,9 +486,6 @@ bool USimpleSaveFile::SaveGame(const class UObject *WorldContext, FString Filena
 		return true;
 	}
 
-	if (InChangeLevel)
-		return true;
-
 	return false;
 }
 
@@ -683,7 +731,7 @@ FCustomSaveData *FindAnyData(int32 ObjectIndex, TArray<FActorSaveData> &InArray)
 FORCEINLINE static bool DoesMatchTag(const FName &InTag, int32 InIndex, const FCustomSaveData &InData)
 {
 	if (!InTag.IsNone())
-		return InData.Tag == InTag;
+		return InData.MatchesTag(InTag);
 
 	return InData.ObjectIndex == InIndex;
 }
@@ -768,10 +816,13 @@ bool USimpleSaveFile::RestoreObjectByTag(class UObject *InObject, const FName &I
 	if (!InGlobal && !CurrentLevelData)
 		return false;
 
+	FName SplitParentTag, SplitTag;
+	FCustomSaveData::SplitTag(InTag, SplitParentTag, SplitTag);
+
 	const TArray<FCustomSaveData> &InData = InGlobal ? CustomObjects : CurrentLevelData->CustomObjects;
 	for (int32 i=0; i<InData.Num(); i++)
 	{
-		if (InData.GetData()[i].Tag == InTag)
+		if (InData.GetData()[i].MatchesTag(InTag, SplitParentTag, SplitTag))
 		{
 			if (InGlobal)
 			{
@@ -799,10 +850,13 @@ bool USimpleSaveFile::RestoreActorByTag(class AActor *InActor, const FName &InTa
 	if (!InGlobal && !CurrentLevelData)
 		return false;
 
+	FName SplitParentTag, SplitTag;
+	FCustomSaveData::SplitTag(InTag, SplitParentTag, SplitTag);
+
 	const TArray<FActorSaveData> &InData = InGlobal ? GlobalActors : CurrentLevelData->Actors;
 	for (int32 i=0; i<InData.Num(); i++)
 	{
-		if (InData.GetData()[i].Custom.Tag == InTag)
+		if (InData.GetData()[i].Custom.MatchesTag(InTag, SplitParentTag, SplitTag))
 		{
 			if (InGlobal)
 			{
@@ -818,15 +872,16 @@ bool USimpleSaveFile::RestoreActorByTag(class AActor *InActor, const FName &InTa
 			InActor->GetComponents(InComponents);
 
 
-			//Go through components
+			//Go through components, they are saved under the full tag of the actor
+			const FName &ActorTag = InTag;
 			for (int32 j=0; j<InComponents.Num(); j++)
 			{
-				FName ComponentTag = *FString::Printf(TEXT("%s.%s"), *InTag.ToString(), *InComponents.GetData()[j]->GetName());
+				const FName ComponentName = InComponents.GetData()[j]->GetFName();
 
 				int32 iComponentIndex = INDEX_NONE;
 				for (int32 k=0; k<InData.GetData()[i].Components.Num(); k++)
 				{
-					if (InData.GetData()[i].Components.GetData()[k].Custom.Tag == ComponentTag)
+					if (InData.GetData()[i].Components.GetData()[k].Custom.IsChildTag(ActorTag, ComponentName))
 					{
 						iComponentIndex = InData.GetData()[i].Components.GetData()[k].Custom.ObjectIndex;
 						break;
@@ -933,7 +988,7 @@ bool USimpleSaveFile::GetObjectTag(class UObject *InObject, FName &OutTag, int32
 //=================================================================
 // 
 //=================================================================
-FActorSaveData *USimpleSaveFile::AddActorToSave(FLevelSaveData *InLevelData, class AActor *InActor, const FName &InTag)
+FActorSaveData *USimpleSaveFile::AddActorToSave(FLevelSaveData *InLevelData, class AActor *InActor, const FName &InTag, const FName &InParentTag)
 {
 	int32 i = LocalSaveObjects.Find(InActor);
 	if (i != INDEX_NONE)
@@ -953,6 +1008,7 @@ FActorSaveData *USimpleSaveFile::AddActorToSave(FLevelSaveData *InLevelData, cla
 	if (!InTag.IsNone())
 	{
 		NewData.Custom.Tag = InTag;
+		NewData.Custom.ParentTag = InParentTag;
 	}
 	else
 	{
@@ -1016,36 +1072,38 @@ FActorSaveData *USimpleSaveFile::AddActorToSave(FLevelSaveData *InLevelData, cla
 		pData = &GlobalActors.GetData()[i];
 	}
 
+	//Components and attached actors are under the full tag, only nested attachments create a name for it
+	const FName FullTag = FCustomSaveData::MakeChildTag(InParentTag, InTag);
+
+	//Components of recreated actors are new objects, references to them can only be resolved through their records
+	class ISaveInterface *pActorInterface = Cast<ISaveInterface>(InActor);
+	const bool bRecreated = pActorInterface && pActorInterface->ShouldDeleteOnRestore();
+
 	TArray<class UActorComponent*> InComponents;
 	InActor->GetComponents(InComponents);
 
 	for (int32 j=0; j<InComponents.Num(); j++)
 	{
-		if (InComponents.GetData()[j]->ComponentTags.Contains(Name_DontSave))
+		class UActorComponent *pComponent = InComponents.GetData()[j];
+		if (pComponent->ComponentTags.Contains(Name_DontSave))
 			continue;
 
 		//Never save these unless specified
-		if (!InComponents.GetData()[j]->ComponentTags.Contains(Name_ForceSave))
-		{
-			TSubclassOf<class UActorComponent> ComponentClass = InComponents.GetData()[j]->GetClass();
-			if (ComponentClass->IsChildOf(UMeshComponent::StaticClass()) || 
-				ComponentClass->IsChildOf(UFXSystemComponent::StaticClass()) || 
-				ComponentClass->IsChildOf(UAudioComponent::StaticClass()) ||
-				ComponentClass->IsChildOf(UShapeComponent::StaticClass()) ||
-				ComponentClass->IsChildOf(UArrowComponent::StaticClass()) ||
-				ComponentClass->IsChildOf(UDrawFrustumComponent::StaticClass()) ||
-				ComponentClass->IsChildOf(UTimelineComponent::StaticClass()))
-			{
+		if (!pComponent->ComponentTags.Contains(Name_ForceSave))
+		{
+			const FSimpleSaveClassLayout *pLayout = GetClassLayout(pComponent->GetClass());
+			if (pLayout->ExcludedComponent)
+				continue;
+
+			//Nothing would be restored, root components move with the actor. Placed ones are referenced by path
+			if (!bRecreated && !pLayout->HasSaveState && (!pLayout->CanMove || pComponent == InActor->GetRootComponent() || CastChecked<USceneComponent>(pComponent)->Mobility != EComponentMobility::Movable))
 				continue;
-			}
 		}
 
-		AddComponentToSave(InLevelData, InTag, pData, InComponents.GetData()[j]);
+		AddComponentToSave(InLevelData, FullTag, pData, pComponent);
 	}
 
 
-	class ISaveInterface *pActorInterface = Cast<ISaveInterface>(InActor);
-
 	//Save attached actors as well
 	if (!InLevelData)
 	{
@@ -1066,18 +1124,15 @@ FActorSaveData *USimpleSaveFile::AddActorToSave(FLevelSaveData *InLevelData, cla
 
 				if (!InTag.IsNone() && pActorInterface)
 				{
-					FName AttachedTag = pActorInterface->GetAttachedTagName(Attached.GetData()[j]);
-					if (!AttachedTag.IsNone())
-					{
-						TagToUse = *FString::Printf(TEXT("%s.%s"), *InTag.ToString(), *AttachedTag.ToString());
-					}
-					else
+					TagToUse = pActorInterface->GetAttachedTagName(Attached.GetData()[j]);
+					if (TagToUse.IsNone())
 					{
-						UE_LOG(LogTemp, Warning, TEXT("No attached tag for %s"), *InTag.ToString());
+						UE_LOG(LogTemp, Warning, TEXT("No attached tag for %s"), *pData->Custom.GetTagString());
 					}
 				}
 
-				AddActorToSave(InLevelData, Attached.GetData()[j], TagToUse);
+				//Saved as the attached tag under this actor's full tag
+				AddActorToSave(InLevelData, Attached.GetData()[j], TagToUse, TagToUse.IsNone() ? NAME_None : FullTag);
 			}
 		}
 	}
@@ -1100,7 +1155,8 @@ void USimpleSaveFile::AddComponentToSave(FLevelSaveData* InLevelData, const FNam
 	}
 	else
 	{
-		ComponentData.Custom.Tag = *FString::Printf(TEXT("%s.%s"), *InTag.ToString(), *InComponent->GetName());
+		ComponentData.Custom.Tag = InComponent->GetFName();
+		ComponentData.Custom.ParentTag = InTag;
 	}
 
 	if (InLevelData)
@@ -1180,6 +1236,9 @@ bool USimpleSaveFile::SaveData(const class UObject *WorldContext, bool InMultiLe
 	GlobalSaveObjects.Reset();
 	GlobalActors.Reset();
 	CustomObjects.Reset();
+	SharedPayloads.Reset();
+	ReferencedLocalObjects.Reset();
+	QuantizeTransforms = pGameInstance->UseQuantizedTransforms();
 	CurrentLevelData = NULL;
 	SaveTime = InTime;
 	KeepInMemory.Reset();
@@ -1200,6 +1259,8 @@ bool USimpleSaveFile::SaveData(const class UObject *WorldContext, bool InMultiLe
 		AddActorToSave(NULL, It.Value(), It.Key());
 	}
 
+	WaitForLevelPacking();
+
 	if (!InMultiLevel)
 	{
 		Levels.Reset();
@@ -1241,24 +1302,8 @@ bool USimpleSaveFile::SaveData(const class UObject *WorldContext, bool InMultiLe
 		}
 
 		//UE_LOG(LogTemp, Error, TEXT("Forcing component \"%s\" on actor \"%s\" to save with data %s!"), *AttachParents.GetData()[i]->GetName(), *pActor->GetActorLabel(), *pActorData->Custom.Name.ToString());
-		AddComponentToSave(bGlobal ? NULL : CurrentLevelData, pActorData->Custom.Tag, pActorData, AttachParents.GetData()[i]);
-
-		/*
-		//Add all the components in the lineage
-		class USceneComponent *pComponentToSave = AttachParents.GetData()[i];
-		while (pComponentToSave && pComponentToSave != pActor->GetRootComponent() && pComponentToSave->GetOwner() == pActor)
-		{
-			if (!GlobalSaveObjects.Contains(pComponentToSave) && !LocalSaveObjects.Contains(pComponentToSave))
-			{
-				UE_LOG(LogTemp, Error, TEXT("Forcing component \"%s\" on actor \"%s\" to save!"), *pComponentToSave->GetName(), *pActor->GetActorLabel());
-
-				AddComponentToSave(CurrentLevelData, pActorData->Custom.Tag, pActorData, pComponentToSave);
-			}
-
-
-			pComponentToSave = pComponentToSave->GetAttachParent();
-		}
-		*/
+		//Same key AddActorToSave uses for the actor's own components
+		AddComponentToSave(bGlobal ? NULL : CurrentLevelData, FCustomSaveData::MakeChildTag(pActorData->Custom.ParentTag, pActorData->Custom.Tag), pActorData, AttachParents.GetData()[i]);
 	}
 
 	//Save global actors
@@ -1324,7 +1369,7 @@ bool USimpleSaveFile::SaveData(const class UObject *WorldContext, bool InMultiLe
 		UE_LOG(LogTemp, Display, TEXT("Saved global actor \"%s\" of class \"%s\" with tag \"%s\" and size: %s"), 
 		*GlobalActors.GetData()[i].Custom.Name.ToString(), 
 		*GlobalActors.GetData()[i].Custom.Class->GetName(), 
-		*GlobalActors.GetData()[i].Custom.Tag.ToString(), 
+		*GlobalActors.GetData()[i].Custom.GetTagString(), 
 		*GlobalActors.GetData()[i].Custom.GetSizeString()); 
 	}
 
@@ -1334,7 +1379,7 @@ bool USimpleSaveFile::SaveData(const class UObject *WorldContext, bool InMultiLe
 		UE_LOG(LogTemp, Display, TEXT("Saved global object \"%s\" class \"%s\" with tag \"%s\" and size: %s"), 
 		*CustomObjects.GetData()[i].Name.ToString(), 
 		*CustomObjects.GetData()[i].Class->GetName(), 
-		*CustomObjects.GetData()[i].Tag.ToString(), 
+		*CustomObjects.GetData()[i].GetTagString(), 
 		*CustomObjects.GetData()[i].GetSizeString());
 	}
 
@@ -1344,7 +1389,7 @@ bool USimpleSaveFile::SaveData(const class UObject *WorldContext, bool InMultiLe
 		UE_LOG(LogTemp, Display, TEXT("Saved local actor \"%s\" class \"%s\" with tag \"%s\" and size: %s"), 
 		*CurrentLevelData->Actors.GetData()[i].Custom.Name.ToString(), 
 		*CurrentLevelData->Actors.GetData()[i].Custom.Class->GetName(), 
-		*CurrentLevelData->Actors.GetData()[i].Custom.Tag.ToString(),
+		*CurrentLevelData->Actors.GetData()[i].Custom.GetTagString(),
 		*CurrentLevelData->Actors.GetData()[i].Custom.GetSizeString()); 
 	}
 
@@ -1354,7 +1399,7 @@ bool USimpleSaveFile::SaveData(const class UObject *WorldContext, bool InMultiLe
 		UE_LOG(LogTemp, Display, TEXT("Saved local object \"%s\" class \"%s\" with tag \"%s\" and size: %s"), 
 		*CurrentLevelData->CustomObjects.GetData()[i].Name.ToString(), 
 		*CurrentLevelData->CustomObjects.GetData()[i].Class->GetName(), 
-		*CurrentLevelData->CustomObjects.GetData()[i].Tag.ToString(),
+		*CurrentLevelData->CustomObjects.GetData()[i].GetTagString(),
 		*CurrentLevelData->CustomObjects.GetData()[i].GetSizeString());
 	}
 	*/
@@ -1388,6 +1433,50 @@ bool USimpleSaveFile::SaveData(const class UObject *WorldContext, bool InMultiLe
 		SaveActorAttachParents(CurrentLevelData->Actors.GetData()[i], false);
 	}
 
+	//=========================================================================================
+	// DELTA SAVING
+	//=========================================================================================
+
+	PruneUnchangedLocalRecords(pGameInstance);
+
+	//=========================================================================================
+	// SHARED PAYLOADS
+	//=========================================================================================
+
+	TArray<FCustomSaveData*> Records;
+	for (int32 i=0; i<GlobalActors.Num(); i++)
+	{
+		Records.Add(&GlobalActors.GetData()[i].Custom);
+		for (int32 j=0; j<GlobalActors.GetData()[i].Components.Num(); j++)
+		{
+			Records.Add(&GlobalActors.GetData()[i].Components.GetData()[j].Custom);
+		}
+	}
+
+	for (int32 i=0; i<CustomObjects.Num(); i++)
+	{
+		Records.Add(&CustomObjects.GetData()[i]);
+	}
+
+	ShareIdenticalPayloads(Records, SharedPayloads, true);
+
+	Records.Reset();
+	for (int32 i=0; i<CurrentLevelData->Actors.Num(); i++)
+	{
+		Records.Add(&CurrentLevelData->Actors.GetData()[i].Custom);
+		for (int32 j=0; j<CurrentLevelData->Actors.GetData()[i].Components.Num(); j++)
+		{
+			Records.Add(&CurrentLevelData->Actors.GetData()[i].Components.GetData()[j].Custom);
+		}
+	}
+
+	for (int32 i=0; i<CurrentLevelData->CustomObjects.Num(); i++)
+	{
+		Records.Add(&CurrentLevelData->CustomObjects.GetData()[i]);
+	}
+
+	ShareIdenticalPayloads(Records, CurrentLevelData->SharedPayloads, false);
+
 	//=========================================================================================
 	// CLEAN UP & FINISH
 	//=========================================================================================
@@ -1401,6 +1490,9 @@ bool USimpleSaveFile::SaveData(const class UObject *WorldContext, bool InMultiLe
 		CurrentLevelData = NULL;
 	}
 
+	//Classes may be unloaded before the next save
+	ClassLayouts.Reset();
+
 	//
 	//pGameInstance->SetSaveGame(this);
 
@@ -1479,7 +1571,7 @@ void USimpleSaveFile::SaveActorAttachParents(FActorSaveData &InData, bool InGlob
 			InData.Custom.OuterIsGlobal = false;
 		}
 
-		InData.RelativeTransform = pActor->GetRootComponent()->GetRelativeTransform();
+		InData.RelativeTransform.Set(pActor->GetRootComponent()->GetRelativeTransform(), QuantizeTransforms);
 		InData.AttachSocketName = pActor->GetAttachParentSocketName();
 
 		/*
@@ -1492,6 +1584,7 @@ void USimpleSaveFile::SaveActorAttachParents(FActorSaveData &InData, bool InGlob
 	else
 	{
 		InData.AttachSocketName = NAME_None;
+		InData.RelativeTransform.Reset();
 		InData.Custom.OuterObjectIndex = INDEX_NONE;
 	}
 }
@@ -1561,21 +1654,26 @@ bool USimpleSaveFile::HandleRestore_BasicObjects(class UObject* WorldContext, fl
 	GlobalSaveObjects.Reset();
 	LocalSaveObjects.Reset();
 
+	//Only RestoreSaveFile starts loading in place, after checking the settings that allow it
+	RestoreInPlace = pGameInstance->IsRestoringInPlace();
+	UnchangedValues = 0;
+
 	SetCurrentMapName(WorldContext);
 
-	bool bLevelChange = pGameInstance->InLevelChange();
+	//Saved object paths are pointed to this world
+	RestoreWorldPath = WorldContext->GetWorld()->GetPathName();
 
-	//Find level data
-	CurrentLevelData = NULL;
-	for (int32 i = 0; i < Levels.Num(); i++)
+	//Nothing in the level has been restored yet, unless restoring over the level as it is
+	if (pGameInstance->UseDeltaSaving() && !RestoreInPlace)
 	{
-		if (Levels.GetData()[i].LevelName == CurrentMapName)
-		{
-			CurrentLevelData = &Levels.GetData()[i];
-			break;
-		}
+		pGameInstance->CaptureLevelBaseline(WorldContext);
 	}
 
+	bool bLevelChange = pGameInstance->InLevelChange();
+
+	//Find level data, the others are only needed when their level is entered
+	CurrentLevelData = FindLevelData(CurrentMapName);
+
 	//If somehow we didn't have the data
 	if (!CurrentLevelData && !bLevelChange)
 	{
@@ -1668,7 +1766,21 @@ bool USimpleSaveFile::HandleRestore_RecreateAllObjects(class UObject *WorldConte
 		}
 
 		RespawnOrFindActors(WorldContext, CurrentLevelData->Actors, LocalSaveObjects, false);
+		GatherUnchangedPlacedObjects(WorldContext);
+	}
+
+	//Recreated actors kept for an in-place restore that no record took after all
+	for (auto It = InPlaceActors.CreateIterator(); It; ++It)
+	{
+		if (IsValid(It.Value()) && !ReturnToActorPool(It.Value()))
+		{
+			It.Value()->Destroy();
+		}
 	}
+	InPlaceActors.Reset();
+
+	//Now that every saved actor exists, restore the recreated ones before they begin play
+	FinishDeferredSpawns();
 
 	LoadingScreenModule.SetLoadingScreenStatus(FText::FromString(TEXT("Recreating dynamic objects...")));
 
@@ -1681,6 +1793,9 @@ bool USimpleSaveFile::HandleRestore_RecreateAllObjects(class UObject *WorldConte
 		RecreateDynamicObjects(CurrentLevelData, CurrentLevelData->CustomObjects, false);
 	}
 
+	//Every object exists now, decode their values while the actors are being restored
+	StartDecodingRecords();
+
 	return true;
 }
 
@@ -1891,6 +2006,16 @@ bool USimpleSaveFile::HandleRestore_CallOnRestore(class UObject* WorldContext)
 		}
 	}
 
+	//Placed objects that were left as they were loaded
+	for (int32 i = 0; i < UnchangedPlacedObjects.Num(); i++)
+	{
+		class ISaveInterface* pInterface = Cast<ISaveInterface>(UnchangedPlacedObjects.GetData()[i]);
+		if (pInterface)
+		{
+			pInterface->OnRestore(pGameInstance, pController);
+		}
+	}
+
 	return true;
 }
 
@@ -1899,9 +2024,28 @@ bool USimpleSaveFile::HandleRestore_CallOnRestore(class UObject* WorldContext)
 //=================================================================
 bool USimpleSaveFile::HandleRestore_Finish(class UObject* WorldContext, bool InTriggerPostLevelChange)
 {
+	WaitForDecodedRecords();
+
 	CurrentLevelData = NULL;
 
+	//The loaded save stays around until the next one, so everything it restored is packed
+	StartPackingLevels();
+
 	GatheredClasses.Reset();
+	DeferredSpawns.Reset();
+	SpawnedActors.Reset();
+	PreRestoredObjects.Reset();
+	PreRestoreCalled.Reset();
+	UnchangedPlacedObjects.Reset();
+	DestroyActorPool();
+
+	if (RestoreInPlace)
+	{
+		UE_LOG(LogTemp, Display, TEXT("Restored in place, %d values were already the same"), UnchangedValues);
+	}
+
+	RestoreInPlace = false;
+	InPlaceActors.Reset();
 
 	if (InTriggerPostLevelChange)
 	{
@@ -2166,6 +2310,27 @@ void USimpleSaveFile::ClearActorsOnRestore(class UObject *WorldContext, bool IsL
 	TArray<class AActor*> AllActors;
 	UGameplayStatics::GetAllActorsWithInterface(WorldContext, USaveInterface::StaticClass(), AllActors);
 
+	//Restoring in place only removes the recreated actors that no longer exist in the save
+	TMap<FName, const FActorSaveData*> Recreated;
+	if (RestoreInPlace)
+	{
+		for (int32 i=0; i<GlobalActors.Num(); i++)
+		{
+			if (GlobalActors.GetData()[i].Custom.Recreate)
+			{
+				Recreated.Add(GlobalActors.GetData()[i].Custom.Name, &GlobalActors.GetData()[i]);
+			}
+		}
+
+		for (int32 i=0; CurrentLevelData && i<CurrentLevelData->Actors.Num(); i++)
+		{
+			if (CurrentLevelData->Actors.GetData()[i].Custom.Recreate)
+			{
+				Recreated.Add(CurrentLevelData->Actors.GetData()[i].Custom.Name, &CurrentLevelData->Actors.GetData()[i]);
+			}
+		}
+	}
+
 	//Go through all the actors
 	for (int32 i=AllActors.Num()-1; i>=0; i--)
 	{
@@ -2189,6 +2354,18 @@ void USimpleSaveFile::ClearActorsOnRestore(class UObject *WorldContext, bool IsL
 
 		if (pInterface->ShouldDeleteOnRestore() && (!IsLevelChange || !pInterface->ShouldRespawnOnLevelChange()))
 		{
+			const FActorSaveData *pSaved = Recreated.FindRef(AllActors.GetData()[i]->GetFName());
+			if (pSaved && pSaved->Custom.Class.ToSoftObjectPath() == FSoftObjectPath(AllActors.GetData()[i]->GetClass()))
+			{
+				InPlaceActors.Add(pSaved->Custom.Name, AllActors.GetData()[i]);
+				continue;
+			}
+
+			if (ReturnToActorPool(AllActors.GetData()[i]))
+			{
+				continue;
+			}
+
 #if WITH_EDITOR
 			if (GEditor->GetEditorSubsystem<ULayersSubsystem>())
 			{
@@ -2213,6 +2390,104 @@ void USimpleSaveFile::ClearActorsOnRestore(class UObject *WorldContext, bool IsL
 	}
 }
 
+//=================================================================
+// Hides the actor so it can be reused instead of destroyed
+//=================================================================
+bool USimpleSaveFile::ReturnToActorPool(class AActor *InActor)
+{
+	class ISaveInterface *pInterface = Cast<ISaveInterface>(InActor);
+	if (!pInterface || !pInterface->CanBePooled())
+		return false;
+
+	//Keep it simple, anything attached to it would need to be pooled as well
+	TArray<class AActor*> Children;
+	InActor->GetAttachedActors(Children);
+	if (Children.Num() > 0)
+		return false;
+
+	FPooledActors::FState State;
+	State.Hidden = InActor->IsHidden();
+	State.Collision = InActor->GetActorEnableCollision();
+	State.Tick = InActor->IsActorTickEnabled();
+
+	InActor->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	InActor->SetActorHiddenInGame(true);
+	InActor->SetActorEnableCollision(false);
+	InActor->SetActorTickEnabled(false);
+
+	FPooledActors &Pool = ActorPool.FindOrAdd(InActor->GetClass());
+	Pool.Actors.Add(InActor);
+	Pool.States.Add(State);
+
+	pInterface->OnReturnedToPool();
+	return true;
+}
+
+//=================================================================
+// 
+//=================================================================
+class AActor *USimpleSaveFile::TakeFromActorPool(UClass *InClass, const FTransform &InTransform)
+{
+	FPooledActors *pPool = ActorPool.Find(InClass);
+	if (!pPool)
+		return NULL;
+
+	while (pPool->Actors.Num() > 0)
+	{
+		class AActor *pActor = pPool->Actors.Pop(false);
+		const FPooledActors::FState State = pPool->States.Num() > 0 ? pPool->States.Pop(false) : FPooledActors::FState();
+		if (!IsValid(pActor))
+			continue;
+
+		pActor->SetActorTransform(InTransform, false, NULL, ETeleportType::ResetPhysics);
+		pActor->SetActorHiddenInGame(State.Hidden);
+		pActor->SetActorEnableCollision(State.Collision);
+		pActor->SetActorTickEnabled(State.Tick);
+
+		class ISaveInterface *pInterface = Cast<ISaveInterface>(pActor);
+		if (pInterface)
+		{
+			pInterface->OnTakenFromPool();
+		}
+
+		return pActor;
+	}
+
+	return NULL;
+}
+
+//=================================================================
+// 
+//=================================================================
+bool USimpleSaveFile::IsInActorPool(const class AActor *InActor) const
+{
+	if (ActorPool.Num() == 0 || !InActor)
+		return false;
+
+	const FPooledActors *pPool = ActorPool.Find(InActor->GetClass());
+	return pPool && pPool->Actors.Contains(InActor);
+}
+
+//=================================================================
+// Destroys actors that were not needed by the restore
+//=================================================================
+void USimpleSaveFile::DestroyActorPool()
+{
+	for (auto It = ActorPool.CreateIterator(); It; ++It)
+	{
+		for (int32 i=0; i<It.Value().Actors.Num(); i++)
+		{
+			class AActor *pActor = It.Value().Actors.GetData()[i];
+			if (IsValid(pActor))
+			{
+				pActor->Destroy();
+			}
+		}
+	}
+
+	ActorPool.Reset();
+}
+
 //=================================================================
 // 
 //=================================================================
@@ -2323,9 +2598,6 @@ void USimpleSaveFile::RespawnOrFindActors(class UObject *WorldContext, const TAr
 {
 	class UWorld *pWorld = WorldContext->GetWorld();
 
-	FActorSpawnParameters Parameters;
-	Parameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-
 	//Go through all the actors
 	for (int32 i=0; i<InData.Num(); i++)
 	{
@@ -2353,10 +2625,25 @@ void USimpleSaveFile::RespawnOrFindActors(class UObject *WorldContext, const TAr
 			continue;
 		}
 
-		//Respawn if needed
+		//Respawn if needed, construction and BeginPlay wait until saved data has been applied
 		if (MyData.Custom.Recreate)
 		{
-			pActor = pWorld->SpawnActor(ObjectClass, &MyData.Transform, Parameters);
+			//Still there when restoring in place
+			InPlaceActors.RemoveAndCopyValue(MyData.Custom.Name, pActor);
+
+			if (!IsValid(pActor))
+			{
+				pActor = TakeFromActorPool(ObjectClass.Get(), MyData.Transform.Get());
+			}
+
+			if (!pActor)
+			{
+				pActor = pWorld->SpawnActorDeferred<AActor>(ObjectClass.Get(), MyData.Transform.Get(), NULL, NULL, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+				if (IsValid(pActor))
+				{
+					DeferredSpawns.Add(FSimpleDeferredSpawn(pActor, i, InGlobal));
+				}
+			}
 		}
 		else
 		{
@@ -2364,6 +2651,9 @@ void USimpleSaveFile::RespawnOrFindActors(class UObject *WorldContext, const TAr
 			UGameplayStatics::GetAllActorsOfClass(WorldContext, (TSubclassOf<AActor>)ObjectClass, AllActors);
 			for (int32 j=0; j<AllActors.Num(); j++)
 			{
+				if (IsInActorPool(AllActors.GetData()[j]))
+					continue;
+
 				if (!MyData.Custom.Tag.IsNone())
 				{
 					class ISaveInterface *pInterface = Cast<ISaveInterface>(AllActors.GetData()[j]);
@@ -2372,7 +2662,7 @@ void USimpleSaveFile::RespawnOrFindActors(class UObject *WorldContext, const TAr
 						continue;
 					}
 
-					if (pInterface->GetSavingTag() == MyData.Custom.Tag)
+					if (MyData.Custom.MatchesTag(pInterface->GetSavingTag()))
 					{
 						pActor = AllActors.GetData()[j];
 						break;
@@ -2402,6 +2692,62 @@ void USimpleSaveFile::RespawnOrFindActors(class UObject *WorldContext, const TAr
 	}
 }
 
+//=================================================================
+// Applies saved data to the deferred actors and finishes spawning them
+//=================================================================
+void USimpleSaveFile::FinishDeferredSpawns()
+{
+	for (int32 i=0; i<DeferredSpawns.Num(); i++)
+	{
+		const FSimpleDeferredSpawn &Spawn = DeferredSpawns.GetData()[i];
+		class AActor *pActor = Spawn.Actor;
+
+		const TArray<FActorSaveData> *pArray = Spawn.Global ? &GlobalActors : (CurrentLevelData ? &CurrentLevelData->Actors : NULL);
+		if (!IsValid(pActor) || !pArray || !pArray->IsValidIndex(Spawn.Index))
+			continue;
+
+		const FActorSaveData &MyData = pArray->GetData()[Spawn.Index];
+
+		//Only native components exist at this point, references to objects that don't exist yet are resolved again in RestoreActor
+		UnresolvedObjectReferences = 0;
+		RestoreCustomData(pActor, MyData.Custom);
+		if (UnresolvedObjectReferences == 0)
+		{
+			PreRestoredObjects.Add(pActor);
+		}
+
+		for (int32 j=0; j<MyData.Components.Num(); j++)
+		{
+			const FComponentSaveData &ComponentData = MyData.Components.GetData()[j];
+			class UActorComponent *pComponent = GetComponent(pActor, ComponentData);
+			if (!pComponent)
+				continue;
+
+			UnresolvedObjectReferences = 0;
+			RestoreComponent(pActor, pComponent, ComponentData);
+			if (UnresolvedObjectReferences == 0)
+			{
+				PreRestoredObjects.Add(pComponent);
+			}
+		}
+
+		pActor->FinishSpawning(MyData.Transform.Get());
+
+		if (!IsValid(pActor))
+		{
+			UE_LOG(LogTemp, Fatal, TEXT("Respawned actor \"%s\" was destroyed while finishing spawning"), *MyData.Custom.Name.ToString());
+			continue;
+		}
+
+		SpawnedActors.Add(pActor);
+
+		//Registers the components created by the construction script too
+		OnRestoreActor(MyData, pActor, Spawn.Global);
+	}
+
+	DeferredSpawns.Reset();
+}
+
 //=================================================================
 // 
 //=================================================================
@@ -2413,15 +2759,21 @@ void USimpleSaveFile::RestoreActor(FLevelSaveData *InLevelData, class AActor *In
 		return;
 	}
 
-	if (InActor->GetRootComponent() && InActor->GetRootComponent()->Mobility == EComponentMobility::Movable)
+	//Overlaps and child transforms are updated once when the actor is fully restored
+	class USceneComponent *pRoot = InActor->GetRootComponent();
+	FScopedMovementUpdate MovementScope(pRoot, EScopedUpdate::DeferredUpdates);
+
+	//Actors we spawned ourselves are already at the saved transform
+	if (pRoot && pRoot->Mobility == EComponentMobility::Movable && InData.Transform.IsSet() && !SpawnedActors.Contains(InActor) && !InData.Transform.Equals(InActor->GetActorTransform()))
 	{
-		InActor->SetActorLocation(InData.Transform.GetLocation());
-		InActor->SetActorRotation(InData.Transform.GetRotation().Rotator());
-		InActor->SetActorScale3D(InData.Transform.GetScale3D());
+		InActor->SetActorTransform(InData.Transform.Get(), false, NULL, ETeleportType::TeleportPhysics);
 	}
 
 	//Restore actor custom data
-	RestoreCustomData(InActor, InData.Custom);
+	if (!PreRestoredObjects.Contains(InActor))
+	{
+		RestoreCustomData(InActor, InData.Custom);
+	}
 
 	//Reattach to parent
 	if (InData.Custom.OuterObjectIndex != INDEX_NONE)
@@ -2434,7 +2786,7 @@ void USimpleSaveFile::RestoreActor(FLevelSaveData *InLevelData, class AActor *In
 			class ISaveInterface *pInterface = Cast<ISaveInterface>(InActor);
 			if (pInterface)
 			{
-				pInterface->HandleReattach(InActor, pParent, InData.AttachSocketName, InData.RelativeTransform);
+				pInterface->HandleReattach(InActor, pParent, InData.AttachSocketName, InData.RelativeTransform.Get());
 			}
 			else
 			{
@@ -2453,7 +2805,7 @@ void USimpleSaveFile::RestoreActor(FLevelSaveData *InLevelData, class AActor *In
 	for (int32 i=0; i<InData.Components.Num(); i++)
 	{
 		class UActorComponent *pComponent = GetComponent(InActor, InData.Components.GetData()[i]);
-		if (pComponent)
+		if (pComponent && !PreRestoredObjects.Contains(pComponent))
 		{
 			RestoreComponent(InActor, pComponent, InData.Components.GetData()[i]);
 		}
@@ -2466,7 +2818,7 @@ void USimpleSaveFile::RestoreActor(FLevelSaveData *InLevelData, class AActor *In
 void ISaveInterface::HandleReattach(class AActor *InActor, class USceneComponent *InComponent, const FName &InSocket, const FTransform &InRelativeTransform)
 {
 	InActor->AttachToComponent(InComponent, FAttachmentTransformRules::KeepWorldTransform, InSocket);
-	InActor->SetActorRelativeTransform(InRelativeTransform);
+	InActor->SetActorRelativeTransform(InRelativeTransform, false, NULL, ETeleportType::TeleportPhysics);
 }
 
 //=================================================================
@@ -2496,14 +2848,14 @@ void USimpleSaveFile::RestoreComponent(class AActor *InActor, class UActorCompon
 {
 	if (!IsValid(InComponent))
 	{
-		UE_LOG(LogTemp, Fatal, TEXT("Invalid component with name \"%s\" and tag \"%s\""), *InData.Custom.Name.ToString(), *InData.Custom.Tag.ToString());
+		UE_LOG(LogTemp, Fatal, TEXT("Invalid component with name \"%s\" and tag \"%s\""), *InData.Custom.Name.ToString(), *InData.Custom.GetTagString());
 		return;
 	}
 
 	class USceneComponent *pSceneComponent = Cast<USceneComponent>(InComponent);
-	if (pSceneComponent && pSceneComponent != InActor->GetRootComponent() && pSceneComponent->Mobility == EComponentMobility::Movable)
+	if (pSceneComponent && pSceneComponent != InActor->GetRootComponent() && pSceneComponent->Mobility == EComponentMobility::Movable && !InData.Transform.Equals(pSceneComponent->GetRelativeTransform()))
 	{
-		pSceneComponent->SetRelativeTransform(InData.Transform);
+		pSceneComponent->SetRelativeTransform(InData.Transform.Get(), false, NULL, ETeleportType::TeleportPhysics);
 	}
 
 	RestoreCustomData(InComponent, InData.Custom);
@@ -2512,38 +2864,165 @@ void USimpleSaveFile::RestoreComponent(class AActor *InActor, class UActorCompon
 //=================================================================
 // 
 //=================================================================
-void USimpleSaveFile::RestoreCustomData_Internal(class USimpleSaveFile *InFile, class UObject *InObject, const TMap<FName, FString> &Singles, const TMap<FName, FArrayData> &Arrays, const TMap<FName, FMapData> &Maps)
+const FSimpleSaveClassLayout *USimpleSaveFile::GetClassLayout(const class UStruct *InStruct)
+{
+	TUniquePtr<FSimpleSaveClassLayout> *pFound = ClassLayouts.Find(InStruct);
+	if (pFound)
+	{
+		return pFound->Get();
+	}
+
+	FSimpleSaveClassLayout *pLayout = ClassLayouts.Emplace(InStruct, MakeUnique<FSimpleSaveClassLayout>()).Get();
+
+	uint32 iHash = 0;
+	for (TFieldIterator<FProperty> Property(InStruct); Property; ++Property)
+	{
+		//Closest one wins just like with FindFProperty
+		pLayout->Properties.FindOrAdd(Property->GetFName(), *Property);
+
+		if ((Property->GetPropertyFlags() & CPF_SaveGame) == 0)
+			continue;
+
+		//Same split as in SaveCustomData_Internal
+		uint8 iType = 0;
+		if (CastField<FArrayProperty>(*Property) != NULL || Property->ArrayDim != 1)
+		{
+			pLayout->Arrays.Add(*Property);
+			iType = 1;
+		}
+		else if (CastField<FMapProperty>(*Property) != NULL)
+		{
+			pLayout->Maps.Add(CastField<FMapProperty>(*Property));
+			iType = 2;
+		}
+		else
+		{
+			pLayout->Singles.Add(*Property);
+		}
+
+		iHash = FCrc::StrCrc32(*Property->GetName(), iHash);
+		iHash = FCrc::MemCrc32(&iType, sizeof(iType), iHash);
+	}
+
+	//Zero is reserved for records that don't know their layout
+	pLayout->SchemaHash = iHash != 0 ? (int32)iHash : 1;
+
+	const class UClass *pClass = Cast<UClass>(InStruct);
+	pLayout->HasSaveState = pLayout->Singles.Num() > 0 || pLayout->Arrays.Num() > 0 || pLayout->Maps.Num() > 0 || (pClass && pClass->ImplementsInterface(USaveInterface::StaticClass()));
+
+	if (pClass && pClass->IsChildOf(UActorComponent::StaticClass()))
+	{
+		pLayout->ExcludedComponent = pClass->IsChildOf(UMeshComponent::StaticClass()) || 
+			pClass->IsChildOf(UFXSystemComponent::StaticClass()) || 
+			pClass->IsChildOf(UAudioComponent::StaticClass()) ||
+			pClass->IsChildOf(UShapeComponent::StaticClass()) ||
+			pClass->IsChildOf(UArrowComponent::StaticClass()) ||
+			pClass->IsChildOf(UDrawFrustumComponent::StaticClass()) ||
+			pClass->IsChildOf(UTimelineComponent::StaticClass());
+
+		pLayout->CanMove = pClass->IsChildOf(USceneComponent::StaticClass());
+	}
+
+	return pLayout;
+}
+
+//=================================================================
+// 
+//=================================================================
+FORCEINLINE static class FProperty *FindRestoreProperty(const FSimpleSaveClassLayout *InLayout, const class UStruct *InStruct, const FName &InName)
+{
+	if (!InLayout)
+	{
+		return FindFProperty<FProperty>(InStruct, InName);
+	}
+
+	class FProperty *const *ppProperty = InLayout->Properties.Find(InName);
+	return ppProperty != NULL ? *ppProperty : NULL;
+}
+
+//=================================================================
+// Saved with the same layout so the properties are at the same
+// positions, names are only compared as a sanity check
+//=================================================================
+template<class T>
+FORCEINLINE static T *GetPropertyAt(const FSimpleSaveClassLayout *InLayout, const TArray<T*> &InProperties, int32 InPosition, const class UStruct *InStruct, const FName &InName)
+{
+	if (InProperties.IsValidIndex(InPosition) && InProperties.GetData()[InPosition]->GetFName() == InName)
+	{
+		return InProperties.GetData()[InPosition];
+	}
+
+	return CastField<T>(FindRestoreProperty(InLayout, InStruct, InName));
+}
+
+//=================================================================
+// 
+//=================================================================
+void USimpleSaveFile::RestoreCustomData_Internal(class USimpleSaveFile *InFile, class UObject *InObject, const TMap<FName, FString> &Singles, const TMap<FName, FArrayData> &Arrays, const TMap<FName, FMapData> &Maps, int32 InSchemaHash)
 {
 	class ISaveInterface *pInterface = Cast<ISaveInterface>(InObject);
 	if (pInterface)
 	{
-		pInterface->PreRestore();
+		bool bAlreadyCalled = false;
+		if (InFile != NULL)
+		{
+			InFile->PreRestoreCalled.Add(InObject, &bAlreadyCalled);
+		}
+
+		if (!bAlreadyCalled)
+		{
+			pInterface->PreRestore();
+		}
 	}
 
-	int32 TextPortFlags = PPF_SimpleObjectText;
+	const class UClass *pClass = InObject->GetClass();
+	const FSimpleSaveClassLayout *pLayout = GetClassLayout(InFile, pClass);
+
+	//If the class hasn't changed since saving we can go by position
+	static const TArray<class FProperty*> NoProperties;
+	static const TArray<class FMapProperty*> NoMapProperties;
+	const bool bSameLayout = pLayout != NULL && InSchemaHash != 0 && InSchemaHash == pLayout->SchemaHash;
+	const TArray<class FProperty*> &SingleProperties = bSameLayout ? pLayout->Singles : NoProperties;
+	const TArray<class FProperty*> &ArrayProperties = bSameLayout ? pLayout->Arrays : NoProperties;
+	const TArray<class FMapProperty*> &MapProperties = bSameLayout ? pLayout->Maps : NoMapProperties;
+	int32 iPosition = 0;
+
+	//Values decoded on a worker thread only need to be copied
+	FSimpleDecodedRecord *pDecoded = InFile != NULL ? InFile->ClaimDecodedRecord(Singles, pClass) : NULL;
+
+	//Restoring over the level as it is, values that are already the same are left alone. The live
+	//values are only exported for in-place restores and when the record has something to compare
+	FSimpleSaveData Live;
+	const bool bDiff = InFile != NULL && InFile->RestoreInPlace && (Singles.Num() > 0 || Arrays.Num() > 0 || Maps.Num() > 0);
+	if (bDiff)
+	{
+		SaveBaselineProperties(InObject, Live);
+	}
 
 	//Go through normal variables
-	for (auto It = Singles.CreateConstIterator(); It; ++It)
+	for (auto It = Singles.CreateConstIterator(); It; ++It, ++iPosition)
 	{
-		class FProperty *Property = FindFProperty<FProperty>(InObject->GetClass(), It.Key());
-		if (Property)
+		if (bDiff)
 		{
-			FString Value = It.Value();
-			void *ValuePtr = Property->ContainerPtrToValuePtr<void>(InObject, 0);
-
-			if (HandleRestoreObject(InFile, Property, Value, ValuePtr, 0, InObject))
-			{
-				continue;
-			}
-			
-			if (HandleRestoreStruct(InFile, Property, Value, ValuePtr, 0, InObject)) 
+			const FString *pLive = Live.Singles.Find(It.Key());
+			if (pLive && pLive->Equals(It.Value(), ESearchCase::CaseSensitive))
 			{
+				InFile->UnchangedValues++;
 				continue;
 			}
+		}
 
-			HandleFixSoftObject(InObject, Property, Value);
+		if (pDecoded && pDecoded->Decoded.GetData()[iPosition])
+		{
+			class FProperty *DecodedProperty = pDecoded->Properties.GetData()[iPosition];
+			DecodedProperty->CopySingleValue(DecodedProperty->ContainerPtrToValuePtr<void>(InObject, 0), pDecoded->Buffer.GetData() + pDecoded->Offsets.GetData()[iPosition]);
+			continue;
+		}
 
-			Property->ImportText_Direct(*Value, ValuePtr, InObject, TextPortFlags);
+		class FProperty *Property = GetPropertyAt(pLayout, SingleProperties, iPosition, pClass, It.Key());
+		if (Property)
+		{
+			RestoreValue(InFile, Property, It.Value(), Property->ContainerPtrToValuePtr<void>(InObject, 0), InObject);
 		}
 		else
 		{
@@ -2553,16 +3032,27 @@ void USimpleSaveFile::RestoreCustomData_Internal(class USimpleSaveFile *InFile,
 	}
 
 	//Go through maps
-	for (auto It = Maps.CreateConstIterator(); It; ++It)
+	iPosition = 0;
+	for (auto It = Maps.CreateConstIterator(); It; ++It, ++iPosition)
 	{
-		class FMapProperty *MapProperty = FindFProperty<FMapProperty>(InObject->GetClass(), It.Key());
+		class FMapProperty *MapProperty = GetPropertyAt(pLayout, MapProperties, iPosition, pClass, It.Key());
 		if (!MapProperty)
 		{
 			UE_LOG(LogTemp, Error, TEXT("Failed to find property \"%s\" on object \"%s\""), *It.Key().ToString(), *InObject->GetName());
 			continue;
 		}
 
-		const TMap<FString, FString> Map = It.Value().Data;
+		const TMap<FString, FString> &Map = It.Value().Data;
+
+		if (bDiff)
+		{
+			const FMapData *pLive = Live.Maps.Find(It.Key());
+			if (pLive && pLive->Data.OrderIndependentCompareEqual(Map))
+			{
+				InFile->UnchangedValues++;
+				continue;
+			}
+		}
 
 		FScriptMapHelper_InContainer MapHelper(MapProperty, InObject, 0);
 		MapHelper.EmptyValues();
@@ -2572,36 +3062,21 @@ void USimpleSaveFile::RestoreCustomData_Internal(class USimpleSaveFile *InFile,
 		{
 			int32 Index = MapHelper.AddDefaultValue_Invalid_NeedsRehash();
 
-			FString Key = MapItr.Key();
-
-			if (!HandleRestoreObject(InFile, MapProperty->KeyProp, Key, MapHelper.GetKeyPtr(Index), 0, InObject) &&
-				!HandleRestoreStruct(InFile, MapProperty->KeyProp, Key, MapHelper.GetKeyPtr(Index), 0, InObject))
-			{
-				HandleFixSoftObject(InObject, MapProperty->KeyProp, Key);
-
-				MapProperty->KeyProp->ImportText_Direct(*Key, MapHelper.GetKeyPtr(Index), InObject, TextPortFlags);
-			}
-
-			FString Value = MapItr.Value();
-
-			if (!HandleRestoreObject(InFile, MapProperty->ValueProp, Value, MapHelper.GetValuePtr(Index), 0, InObject) &&
-				!HandleRestoreStruct(InFile, MapProperty->ValueProp, Value, MapHelper.GetValuePtr(Index), 0, InObject))
-			{
-				HandleFixSoftObject(InObject, MapProperty->ValueProp, Value);
+			RestoreValue(InFile, MapProperty->KeyProp, MapItr.Key(), MapHelper.GetKeyPtr(Index), InObject);
 
-				//UE_LOG(LogTemp, Error, TEXT("%s Restoring property %s value %s"), *InObject->GetClass()->GetName(), *MapProperty->GetName(), *Value);
+			//UE_LOG(LogTemp, Error, TEXT("%s Restoring property %s value %s"), *InObject->GetClass()->GetName(), *MapProperty->GetName(), *MapItr.Value());
 
-				MapProperty->ValueProp->ImportText_Direct(*Value, MapHelper.GetValuePtr(Index), InObject, TextPortFlags);
-			}	
+			RestoreValue(InFile, MapProperty->ValueProp, MapItr.Value(), MapHelper.GetValuePtr(Index), InObject);
 		}
 
 		MapHelper.Rehash();
 	}
 
 	//Go through arrays
-	for (auto It = Arrays.CreateConstIterator(); It; ++It)
+	iPosition = 0;
+	for (auto It = Arrays.CreateConstIterator(); It; ++It, ++iPosition)
 	{
-		class FProperty *Property = FindFProperty<FProperty>(InObject->GetClass(), It.Key());
+		class FProperty *Property = GetPropertyAt(pLayout, ArrayProperties, iPosition, pClass, It.Key());
 		if (!Property)
 		{
 			UE_LOG(LogTemp, Error, TEXT("Failed to find property \"%s\" on object \"%s\""), *It.Key().ToString(), *InObject->GetName());
@@ -2610,6 +3085,16 @@ void USimpleSaveFile::RestoreCustomData_Internal(class USimpleSaveFile *InFile,
 
 		const TArray<FString> &Array = It.Value().Data;
 
+		if (bDiff)
+		{
+			const FArrayData *pLive = Live.Arrays.Find(It.Key());
+			if (pLive && pLive->Data == Array)
+			{
+				InFile->UnchangedValues++;
+				continue;
+			}
+		}
+
 		//
 		FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property);
 		if (ArrayProperty)
@@ -2622,17 +3107,7 @@ void USimpleSaveFile::RestoreCustomData_Internal(class USimpleSaveFile *InFile,
 
 			for (int32 Index = 0; Index < Array.Num(); Index++)
 			{
-				FString Value = Array.GetData()[Index];
-				
-				if (HandleRestoreObject(InFile, ArrayProperty->Inner, Value, ArrayHelper.GetRawPtr(Index), 0, InObject))
-					continue;
-
-				if (HandleRestoreStruct(InFile, ArrayProperty->Inner, Value, ArrayHelper.GetRawPtr(Index), 0, InObject))
-					continue;
-
-				HandleFixSoftObject(InObject, ArrayProperty->Inner, Value);
-
-				ArrayProperty->Inner->ImportText_Direct(*Value, ArrayHelper.GetRawPtr(Index), InObject, TextPortFlags);
+				RestoreValue(InFile, ArrayProperty->Inner, Array.GetData()[Index], ArrayHelper.GetRawPtr(Index), InObject);
 			}
 
 			//UE_LOG(LogTemp, Error, TEXT("Restored array property %s on %s with size %d"), *Property->GetName(), *InObject->GetName(), Array.Num());
@@ -2644,204 +3119,571 @@ void USimpleSaveFile::RestoreCustomData_Internal(class USimpleSaveFile *InFile,
 		{
 			for (int32 Index = 0; Index < Array.Num(); Index++)
 			{
-				FString Value = Array.GetData()[Index];
-				void *ValuePtr = Property->ContainerPtrToValuePtr<void>(InObject, Index);
-
-				if (!HandleRestoreObject(InFile, Property, Value, ValuePtr, 0, InObject) &&
-					!HandleRestoreStruct(InFile, Property, Value, ValuePtr, 0, InObject))
-				{
-					HandleFixSoftObject(InObject, Property, Value);
-
-					Property->ImportText_Direct(*Value, ValuePtr, InObject, TextPortFlags);
-				}
+				RestoreValue(InFile, Property, Array.GetData()[Index], Property->ContainerPtrToValuePtr<void>(InObject, Index), InObject);
 			}
 		}
 	}
 }
 
 //=================================================================
-// 
+// Types that ImportText can parse without touching any objects,
+// the worker has no owner object to give it
 //=================================================================
-void USimpleSaveFile::FinishLoading()
+FORCEINLINE static bool CanDecodeOffGameThread(const class FProperty *InProperty)
 {
-	ISimpleSavingLoadingScreenModule& LoadingScreenModule = ISimpleSavingLoadingScreenModule::Get();
-	LoadingScreenModule.SetLoadingScreenStatus(FText::FromString(TEXT("Finishing restoration...")));
+	if (InProperty->ArrayDim != 1)
+		return false;
 
-	GlobalSaveObjects.Reset();
-	LocalSaveObjects.Reset();
+	//Object and instanced references are resolved on the game thread
+	if (CastField<FObjectPropertyBase>(InProperty) || InProperty->HasAnyPropertyFlags(CPF_InstancedReference | CPF_ContainsInstancedReference | CPF_PersistentInstance))
+		return false;
+
+	const FNumericProperty *NumericProperty = CastField<FNumericProperty>(InProperty);
+	if (NumericProperty)
+		return !NumericProperty->IsEnum();
+
+	if (CastField<FBoolProperty>(InProperty) || CastField<FNameProperty>(InProperty) || CastField<FStrProperty>(InProperty))
+		return true;
+
+	const FStructProperty *StructProperty = CastField<FStructProperty>(InProperty);
+	if (!StructProperty)
+		return false;
+
+	const class UScriptStruct *Struct = StructProperty->Struct;
+	return Struct == TBaseStructure<FVector>::Get()
+		|| Struct == TBaseStructure<FVector2D>::Get()
+		|| Struct == TBaseStructure<FRotator>::Get()
+		|| Struct == TBaseStructure<FQuat>::Get()
+		|| Struct == TBaseStructure<FTransform>::Get()
+		|| Struct == TBaseStructure<FLinearColor>::Get()
+		|| Struct == TBaseStructure<FColor>::Get()
+		|| Struct == TBaseStructure<FIntPoint>::Get();
 }
 
 //=================================================================
 // 
 //=================================================================
-void USimpleSaveFile::ClearCurrentLevelAndGlobalData(class UObject *WorldContextObject)
+FSimpleDecodedRecord::FSimpleDecodedRecord()
 {
-	FName MapName = *UGameplayStatics::GetCurrentLevelName(WorldContextObject);
-
-	ClearLevelData(MapName);
-
-	CustomObjects.Reset();
-	GlobalActors.Reset();
+	DoneEvent = FPlatformProcess::GetSynchEventFromPool(true);
 }
 
 //=================================================================
 // 
 //=================================================================
-bool USimpleSaveFile::ClearLevelData(const FName &InLevel)
+FSimpleDecodedRecord::~FSimpleDecodedRecord()
 {
-	for (int32 i=Levels.Num()-1; i>=0; i--)
+	FPlatformProcess::ReturnSynchEventToPool(DoneEvent);
+	DoneEvent = NULL;
+
+	for (int32 i=0; i<Properties.Num(); i++)
 	{
-		if (Levels.GetData()[i].LevelName == InLevel)
+		if (Properties.GetData()[i])
 		{
-			Levels.RemoveAt(i);
-			return true;
+			Properties.GetData()[i]->DestroyValue(Buffer.GetData() + Offsets.GetData()[i]);
 		}
 	}
-
-	return false;
-}
-
-//==============================================================================================================
-//
-//==============================================================================================================
-bool USimpleSaveFile::StripLevelNameString(const FString& InString, FString& OutString)
-{
-	if (InString.Split(TEXT("."), NULL, &OutString, ESearchCase::CaseSensitive, ESearchDir::FromEnd))
-	{
-		return true;
-	}
-
-	if (InString.Split(TEXT("/"), NULL, &OutString, ESearchCase::CaseSensitive, ESearchDir::FromEnd))
-	{
-		return true;
-	}
-
-	OutString = InString;
-	return false;
-}
-
-//=================================================================
-// 
-//=================================================================
-void USimpleSaveFile::SetCurrentMapName(const class UObject * const InObject)
-{
-	FString MapName = InObject->GetWorld()->GetOutermost()->GetName();
-	MapName = InObject->GetWorld()->RemovePIEPrefix(MapName);
-	StripLevelNameString(MapName, MapName);
-	CurrentMapName = *MapName;
 }
 
 //=================================================================
-// 
+// Gathers the records of the objects being restored and decodes
+// them on worker threads
 //=================================================================
-FLevelSaveData *USimpleSaveFile::SaveLevelData(class USaveGameInstance *InInstance, class APlayerController *InController, class APawn *InPawn, const class UObject *WorldContext)
+void USimpleSaveFile::StartDecodingRecords()
 {
-	FName MapName = *UGameplayStatics::GetCurrentLevelName(WorldContext);
+	WaitForDecodedRecords();
 
-	FLevelSaveData *pLevelData = NULL;
-	for (int32 i=0; i<Levels.Num(); i++)
+	for (int32 i=0; i<GlobalActors.Num(); i++)
 	{
-		if (Levels.GetData()[i].LevelName == MapName)
+		AddDecodedRecord(GlobalActors.GetData()[i].Custom, true);
+		for (int32 j=0; j<GlobalActors.GetData()[i].Components.Num(); j++)
 		{
-			pLevelData = &Levels.GetData()[i];
-			break;
+			AddDecodedRecord(GlobalActors.GetData()[i].Components.GetData()[j].Custom, true);
 		}
 	}
 
-	//If no level data
-	if (pLevelData)
+	for (int32 i=0; i<CustomObjects.Num(); i++)
 	{
-		pLevelData->Actors.Reset();
+		AddDecodedRecord(CustomObjects.GetData()[i], true);
 	}
-	else
+
+	if (CurrentLevelData)
 	{
-		FLevelSaveData NewLevelData;
-		NewLevelData.LevelName = MapName;
-		int32 i = Levels.Add(NewLevelData);
-		pLevelData = &Levels.GetData()[i];
+		for (int32 i=0; i<CurrentLevelData->Actors.Num(); i++)
+		{
+			AddDecodedRecord(CurrentLevelData->Actors.GetData()[i].Custom, false);
+			for (int32 j=0; j<CurrentLevelData->Actors.GetData()[i].Components.Num(); j++)
+			{
+				AddDecodedRecord(CurrentLevelData->Actors.GetData()[i].Components.GetData()[j].Custom, false);
+			}
+		}
+
+		for (int32 i=0; i<CurrentLevelData->CustomObjects.Num(); i++)
+		{
+			AddDecodedRecord(CurrentLevelData->CustomObjects.GetData()[i], false);
+		}
 	}
 
-	pLevelData->CustomObjects.Reset();
-	pLevelData->Actors.Reset();
+	if (DecodedRecords.Num() == 0)
+		return;
 
-	TMap<FName, class AActor*> CustomTags;
-	InInstance->GetLocalActorTags(InController, InPawn, CustomTags);
-	for (auto It = CustomTags.CreateConstIterator(); It; ++It)
+	//The records stay alive until WaitForDecodedRecords
+	TArray<FSimpleDecodedRecord*> Records;
+	Records.Reserve(DecodedRecords.Num());
+	for (int32 i=0; i<DecodedRecords.Num(); i++)
 	{
-		AddActorToSave(pLevelData, It.Value(), It.Key());
+		Records.Add(DecodedRecords.GetData()[i].Get());
 	}
 
-	SetCurrentMapName(WorldContext);
-
-	TArray<class AActor*> AllActors;
-	UGameplayStatics::GetAllActorsWithInterface(WorldContext, USaveInterface::StaticClass(), AllActors);
-
-	//Go through all the actors
-	for (int32 i=0; i<AllActors.Num(); i++)
+	DecodeTask = Async(EAsyncExecution::ThreadPool, [Records = MoveTemp(Records)]()
 	{
-		if (IsMarkedForDestruction(AllActors.GetData()[i]))
+		ParallelFor(Records.Num(), [&Records](int32 Index)
 		{
-			continue;
-		}
+			DecodeRecord(*Records.GetData()[Index]);
+		});
+	});
+}
 
-		//If already saved then ignore
-		if (GlobalSaveObjects.Contains(AllActors.GetData()[i]))
-		{
-			//AllActors.RemoveAt(i);
-			continue;
-		}
+//=================================================================
+// Works out on the game thread which values can be decoded and
+// where they go so the worker never needs to look anything up
+//=================================================================
+void USimpleSaveFile::AddDecodedRecord(const FCustomSaveData &InData, bool InGlobal)
+{
+	const TMap<FName, FString> &Singles = InData.GetSingles(GetSharedPayloads(InData));
+	if (Singles.Num() == 0)
+		return;
 
-		if (LocalSaveObjects.Contains(AllActors.GetData()[i]))
-		{
-			//AllActors.RemoveAt(i);
-			continue;
-		}
+	//Shared payloads are only decoded once
+	if (DecodedRecordMap.Contains(&Singles))
+		return;
 
-		ISaveInterface *pInterface = Cast<ISaveInterface>(AllActors.GetData()[i]);
-		if (!pInterface)
-		{
-			//AllActors.RemoveAt(i);
-			continue;
-		}
+	class UObject *pObject = GetRestoreObject(InData, InGlobal);
+	if (!IsValid(pObject) || PreRestoredObjects.Contains(pObject))
+		return;
 
-		if (!pInterface->ShouldSave())
+	const class UClass *pClass = pObject->GetClass();
+	const FSimpleSaveClassLayout *pLayout = GetClassLayout(pClass);
+
+	TUniquePtr<FSimpleDecodedRecord> Record = MakeUnique<FSimpleDecodedRecord>();
+	Record->Singles = &Singles;
+	Record->Class = pClass;
+	Record->Properties.Reserve(Singles.Num());
+	Record->Offsets.Reserve(Singles.Num());
+
+	int32 iSize = 0;
+	bool bAny = false;
+	for (auto It = Singles.CreateConstIterator(); It; ++It)
+	{
+		class FProperty *Property = FindRestoreProperty(pLayout, pClass, It.Key());
+		if (!Property || !CanDecodeOffGameThread(Property) || (It.Value().Len() > 0 && It.Value()[0] == L'!'))
 		{
-			//AllActors.RemoveAt(i);
+			Record->Properties.Add(NULL);
+			Record->Offsets.Add(0);
 			continue;
 		}
 
-		AddActorToSave(pLevelData, AllActors.GetData()[i], NAME_None);
-
-		/*
-		UE_LOG(LogTemp, Error, TEXT("Saving %s with local index %d global index %d in %s"),
-						*AllActors.GetData()[i]->GetName(), 
-						LocalSaveObjects.Find(AllActors.GetData()[i]),
-						GlobalSaveObjects.Find(AllActors.GetData()[i]), 
-						*GetName());		
-						*/
-
-		//LocalSaveObjects.Add(AllActors.GetData()[i]);
+		iSize = Align(iSize, Property->GetMinAlignment());
+		Record->Properties.Add(Property);
+		Record->Offsets.Add(iSize);
+		iSize += Property->GetSize();
+		bAny = true;
 	}
 
-	/*
-	//Now save the actors
-	for (int32 i=0; i<AllActors.Num(); i++)
+	if (!bAny)
+		return;
+
+	Record->Buffer.SetNumZeroed(iSize);
+	Record->Decoded.SetNumZeroed(Record->Properties.Num());
+	for (int32 i=0; i<Record->Properties.Num(); i++)
 	{
-		FActorSaveData ActorData;
-		if (SaveActor(AllActors.GetData()[i], ActorData, true))
+		if (Record->Properties.GetData()[i])
 		{
-			pLevelData->Actors.Add(ActorData);
+			Record->Properties.GetData()[i]->InitializeValue(Record->Buffer.GetData() + Record->Offsets.GetData()[i]);
 		}
 	}
-	*/
 
-	//Now save all objects that haven't been saved yet
-	//SaveDynamicObjects(LocalSaveObjects, pLevelData->CustomObjects, true);
-	return pLevelData;
+	DecodedRecordMap.Add(&Singles, Record.Get());
+	DecodedRecords.Add(MoveTemp(Record));
 }
 
 //=================================================================
-// 
+// Runs on a worker thread
+//=================================================================
+void USimpleSaveFile::DecodeRecord(FSimpleDecodedRecord &InRecord)
+{
+	int32 iExpected = 0;
+	if (!InRecord.State.compare_exchange_strong(iExpected, 1))
+		return;
+
+	int32 iPosition = 0;
+	for (auto It = InRecord.Singles->CreateConstIterator(); It; ++It, ++iPosition)
+	{
+		class FProperty *Property = InRecord.Properties.GetData()[iPosition];
+		if (!Property)
+			continue;
+
+		//No owner, CanDecodeOffGameThread only lets through types that don't need one
+		InRecord.Decoded.GetData()[iPosition] = Property->ImportText_Direct(*It.Value(), InRecord.Buffer.GetData() + InRecord.Offsets.GetData()[iPosition], NULL, PPF_SimpleObjectText) != NULL;
+	}
+
+	InRecord.State.store(2);
+	InRecord.DoneEvent->Trigger();
+}
+
+//=================================================================
+// Returns the decoded values for the record, records the workers
+// haven't started yet are restored on the game thread instead.
+// Decoded values stay for the other records sharing the payload
+//=================================================================
+FSimpleDecodedRecord *USimpleSaveFile::ClaimDecodedRecord(const TMap<FName, FString> &InSingles, const class UClass *InClass)
+{
+	FSimpleDecodedRecord **ppRecord = DecodedRecordMap.Find(&InSingles);
+	if (!ppRecord)
+		return NULL;
+
+	FSimpleDecodedRecord *pRecord = *ppRecord;
+
+	int32 iState = 0;
+	if (pRecord->State.compare_exchange_strong(iState, 3))
+		return NULL;
+
+	//Almost done, waiting is cheaper than parsing it again
+	if (iState == 1)
+	{
+		pRecord->DoneEvent->Wait();
+		iState = pRecord->State.load();
+	}
+
+	return iState == 2 && pRecord->Class == InClass ? pRecord : NULL;
+}
+
+//=================================================================
+// 
+//=================================================================
+void USimpleSaveFile::WaitForDecodedRecords()
+{
+	if (DecodeTask.IsValid())
+	{
+		DecodeTask.Wait();
+		DecodeTask.Reset();
+	}
+
+	DecodedRecordMap.Reset();
+	DecodedRecords.Reset();
+}
+
+//=================================================================
+// 
+//=================================================================
+void USimpleSaveFile::FinishLoading()
+{
+	ISimpleSavingLoadingScreenModule& LoadingScreenModule = ISimpleSavingLoadingScreenModule::Get();
+	LoadingScreenModule.SetLoadingScreenStatus(FText::FromString(TEXT("Finishing restoration...")));
+
+	WaitForDecodedRecords();
+
+	GlobalSaveObjects.Reset();
+	LocalSaveObjects.Reset();
+	ClassLayouts.Reset();
+	RestoreWorldPath.Reset();
+}
+
+//=================================================================
+// 
+//=================================================================
+void USimpleSaveFile::ClearCurrentLevelAndGlobalData(class UObject *WorldContextObject)
+{
+	FName MapName = *UGameplayStatics::GetCurrentLevelName(WorldContextObject);
+
+	ClearLevelData(MapName);
+
+	CustomObjects.Reset();
+	GlobalActors.Reset();
+	SharedPayloads.Reset();
+}
+
+//=================================================================
+// 
+//=================================================================
+bool USimpleSaveFile::ClearLevelData(const FName &InLevel)
+{
+	WaitForLevelPacking();
+
+	for (int32 i=Levels.Num()-1; i>=0; i--)
+	{
+		if (Levels.GetData()[i].LevelName == InLevel)
+		{
+			Levels.RemoveAt(i);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//=================================================================
+// 
+//=================================================================
+FLevelSaveData *USimpleSaveFile::FindLevelData(const FName &InLevel)
+{
+	WaitForLevelPacking();
+
+	for (int32 i=0; i<Levels.Num(); i++)
+	{
+		if (Levels.GetData()[i].LevelName == InLevel)
+		{
+			Levels.GetData()[i].Unpack();
+			return &Levels.GetData()[i];
+		}
+	}
+
+	return NULL;
+}
+
+//=================================================================
+// 
+//=================================================================
+void USimpleSaveFile::UnpackLevels()
+{
+	WaitForLevelPacking();
+
+	for (int32 i=0; i<Levels.Num(); i++)
+	{
+		Levels.GetData()[i].Unpack();
+	}
+}
+
+//=================================================================
+// The worker owns the records it packs, the levels array can change
+// while it runs and the levels are found again by name when done
+//=================================================================
+void USimpleSaveFile::StartPackingLevels()
+{
+	WaitForLevelPacking();
+
+	TArray<FLevelSaveData> Records;
+	for (int32 i=0; i<Levels.Num(); i++)
+	{
+		FLevelSaveData &LevelData = Levels.GetData()[i];
+		if (&LevelData == CurrentLevelData || LevelData.IsPacked() || (LevelData.Actors.Num() == 0 && LevelData.CustomObjects.Num() == 0))
+			continue;
+
+		FLevelSaveData &LevelRecords = Records.AddDefaulted_GetRef();
+		LevelRecords.LevelName = LevelData.LevelName;
+		LevelRecords.Actors = MoveTemp(LevelData.Actors);
+		LevelRecords.CustomObjects = MoveTemp(LevelData.CustomObjects);
+	}
+
+	if (Records.Num() == 0)
+		return;
+
+	PackTask = Async(EAsyncExecution::ThreadPool, [Records = MoveTemp(Records)]() mutable
+	{
+		for (int32 i=0; i<Records.Num(); i++)
+		{
+			Records.GetData()[i].Pack();
+		}
+
+		return MoveTemp(Records);
+	});
+}
+
+//=================================================================
+// 
+//=================================================================
+void USimpleSaveFile::WaitForLevelPacking()
+{
+	if (!PackTask.IsValid())
+		return;
+
+	TArray<FLevelSaveData> Packed = PackTask.Consume();
+
+	for (int32 i=0; i<Packed.Num(); i++)
+	{
+		FLevelSaveData &PackedLevel = Packed.GetData()[i];
+		for (int32 j=0; j<Levels.Num(); j++)
+		{
+			FLevelSaveData &LevelData = Levels.GetData()[j];
+			if (LevelData.LevelName == PackedLevel.LevelName)
+			{
+				LevelData.Actors = MoveTemp(PackedLevel.Actors);
+				LevelData.CustomObjects = MoveTemp(PackedLevel.CustomObjects);
+				LevelData.PackedData = MoveTemp(PackedLevel.PackedData);
+				LevelData.PackedOffsets = MoveTemp(PackedLevel.PackedOffsets);
+				LevelData.PackedActors = PackedLevel.PackedActors;
+				break;
+			}
+		}
+	}
+}
+
+//=================================================================
+// 
+//=================================================================
+void USimpleSaveFile::Serialize(FArchive &Ar)
+{
+	WaitForLevelPacking();
+
+	Super::Serialize(Ar);
+}
+
+//=================================================================
+// 
+//=================================================================
+void USimpleSaveFile::BeginDestroy()
+{
+	WaitForLevelPacking();
+	WaitForDecodedRecords();
+
+	Super::BeginDestroy();
+}
+
+//==============================================================================================================
+//
+//==============================================================================================================
+bool USimpleSaveFile::StripLevelNameString(const FString& InString, FString& OutString)
+{
+	if (InString.Split(TEXT("."), NULL, &OutString, ESearchCase::CaseSensitive, ESearchDir::FromEnd))
+	{
+		return true;
+	}
+
+	if (InString.Split(TEXT("/"), NULL, &OutString, ESearchCase::CaseSensitive, ESearchDir::FromEnd))
+	{
+		return true;
+	}
+
+	OutString = InString;
+	return false;
+}
+
+//=================================================================
+// 
+//=================================================================
+void USimpleSaveFile::SetCurrentMapName(const class UObject * const InObject)
+{
+	CurrentMapName = GetMapName(InObject);
+}
+
+//=================================================================
+// 
+//=================================================================
+FName USimpleSaveFile::GetMapName(const class UObject * const InObject)
+{
+	FString MapName = InObject->GetWorld()->GetOutermost()->GetName();
+	MapName = InObject->GetWorld()->RemovePIEPrefix(MapName);
+	StripLevelNameString(MapName, MapName);
+	return *MapName;
+}
+
+//=================================================================
+// 
+//=================================================================
+FLevelSaveData *USimpleSaveFile::SaveLevelData(class USaveGameInstance *InInstance, class APlayerController *InController, class APawn *InPawn, const class UObject *WorldContext)
+{
+	FName MapName = *UGameplayStatics::GetCurrentLevelName(WorldContext);
+
+	//Records saved before are replaced, so a packed level isn't unpacked for it
+	FLevelSaveData *pLevelData = NULL;
+	for (int32 i=0; i<Levels.Num(); i++)
+	{
+		if (Levels.GetData()[i].LevelName == MapName)
+		{
+			pLevelData = &Levels.GetData()[i];
+			break;
+		}
+	}
+
+	//If no level data
+	if (!pLevelData)
+	{
+		FLevelSaveData NewLevelData;
+		NewLevelData.LevelName = MapName;
+		int32 i = Levels.Add(NewLevelData);
+		pLevelData = &Levels.GetData()[i];
+	}
+
+	pLevelData->ResetRecords();
+
+	TMap<FName, class AActor*> CustomTags;
+	InInstance->GetLocalActorTags(InController, InPawn, CustomTags);
+	for (auto It = CustomTags.CreateConstIterator(); It; ++It)
+	{
+		AddActorToSave(pLevelData, It.Value(), It.Key());
+	}
+
+	SetCurrentMapName(WorldContext);
+
+	TArray<class AActor*> AllActors;
+	UGameplayStatics::GetAllActorsWithInterface(WorldContext, USaveInterface::StaticClass(), AllActors);
+
+	//Go through all the actors
+	for (int32 i=0; i<AllActors.Num(); i++)
+	{
+		if (IsMarkedForDestruction(AllActors.GetData()[i]))
+		{
+			continue;
+		}
+
+		//If already saved then ignore
+		if (GlobalSaveObjects.Contains(AllActors.GetData()[i]))
+		{
+			//AllActors.RemoveAt(i);
+			continue;
+		}
+
+		if (LocalSaveObjects.Contains(AllActors.GetData()[i]))
+		{
+			//AllActors.RemoveAt(i);
+			continue;
+		}
+
+		ISaveInterface *pInterface = Cast<ISaveInterface>(AllActors.GetData()[i]);
+		if (!pInterface)
+		{
+			//AllActors.RemoveAt(i);
+			continue;
+		}
+
+		if (!pInterface->ShouldSave())
+		{
+			//AllActors.RemoveAt(i);
+			continue;
+		}
+
+		AddActorToSave(pLevelData, AllActors.GetData()[i], NAME_None);
+
+		/*
+		UE_LOG(LogTemp, Error, TEXT("Saving %s with local index %d global index %d in %s"),
+						*AllActors.GetData()[i]->GetName(), 
+						LocalSaveObjects.Find(AllActors.GetData()[i]),
+						GlobalSaveObjects.Find(AllActors.GetData()[i]), 
+						*GetName());		
+						*/
+
+		//LocalSaveObjects.Add(AllActors.GetData()[i]);
+	}
+
+	/*
+	//Now save the actors
+	for (int32 i=0; i<AllActors.Num(); i++)
+	{
+		FActorSaveData ActorData;
+		if (SaveActor(AllActors.GetData()[i], ActorData, true))
+		{
+			pLevelData->Actors.Add(ActorData);
+		}
+	}
+	*/
+
+	//Now save all objects that haven't been saved yet
+	//SaveDynamicObjects(LocalSaveObjects, pLevelData->CustomObjects, true);
+	return pLevelData;
+}
+
+//=================================================================
+// 
 //=================================================================
 bool USimpleSaveFile::SaveActor(class AActor *InActor, FActorSaveData &InData)
 {
@@ -2851,10 +3693,19 @@ bool USimpleSaveFile::SaveActor(class AActor *InActor, FActorSaveData &InData)
 		return false;
 	}
 	
-	InData.Transform = InActor->GetActorTransform();
-	
 	SaveCustomData(InActor, InData.Custom);
 
+	//Placed actors that can't move are never moved on restore, recreated ones need it for spawning
+	class USceneComponent *pRoot = InActor->GetRootComponent();
+	if (InData.Custom.Recreate || (pRoot && pRoot->Mobility == EComponentMobility::Movable))
+	{
+		InData.Transform.Set(InActor->GetActorTransform(), QuantizeTransforms);
+	}
+	else
+	{
+		InData.Transform.Reset();
+	}
+
 	for (int32 i=0; i<InData.Components.Num(); i++)
 	{
 		class UActorComponent *pComponent = GetComponent(InActor, InData.Components.GetData()[i]);
@@ -2877,10 +3728,15 @@ bool USimpleSaveFile::SaveComponent(class UActorComponent *InComponent, FCompone
 
 	SaveCustomData(InComponent, InData.Custom);
 
+	//Root components move with the actor
 	class USceneComponent *pScene = Cast<USceneComponent>(InComponent);
-	if (pScene)
+	if (pScene && pScene != pScene->GetOwner()->GetRootComponent() && pScene->Mobility == EComponentMobility::Movable)
+	{
+		InData.Transform.Set(pScene->GetRelativeTransform(), QuantizeTransforms);
+	}
+	else
 	{
-		InData.Transform = pScene->GetRelativeTransform();
+		InData.Transform.Reset();
 	}
 
 	return true;
@@ -2940,10 +3796,12 @@ bool USimpleSaveFile::HandleSaveStruct(class USimpleSaveFile *InFile, FProperty
 
 	int32 PortFlags = PPF_SimpleObjectText;
 
-	OutString = TEXT("(");
+	OutString.Reset();
+	OutString.AppendChar(L'(');
 
 	//
 	int nCount = 0;
+	FString SaveString;
 	bool bHadObject = false;
 	bool bSaveAll = StructProperty->Struct == FDataTableRowHandle::StaticStruct();
 
@@ -2988,28 +3846,29 @@ bool USimpleSaveFile::HandleSaveStruct(class USimpleSaveFile *InFile, FProperty
 
 		if (nCount > 0)
 		{
-			OutString += TEXT(",");
+			OutString.AppendChar(L',');
 		}
 
 		nCount++;
 
-		OutString += Property->GetName() + TEXT("=");
+		Property->GetFName().AppendString(OutString);
+		OutString.AppendChar(L'=');
 
-		FString SaveString;
+		//Values are exported straight to the end of the struct string
+		SaveString.Reset();
 		if (HandleSaveObject(InFile, *Property, InObject, ValuePtr, 0, SaveString))
 		{
 			//UE_LOG(LogTemp, Error, TEXT("Saved object inside struct!"));
 			bHadObject = true;
+			OutString += SaveString;
 		}
 		else
 		{
-			Property->ExportTextItem_Direct(SaveString, ValuePtr, ValuePtr, InObject, PortFlags);
+			Property->ExportTextItem_Direct(OutString, ValuePtr, ValuePtr, InObject, PortFlags);
 		}
-
-		OutString += SaveString;
 	}
 
-	OutString += TEXT(")");
+	OutString.AppendChar(L')');
 
 	//UE_LOG(LogTemp, Error, TEXT("Saving struct \"%s\" as \"%s\""), *StructProperty->GetName(), *OutString);
 	return true;
@@ -3112,10 +3971,22 @@ bool USimpleSaveFile::IsValidDynamicObject(class UObject *InObject)
 //=================================================================
 // 
 //=================================================================
-FString USimpleSaveFile::GetSavingObjectPrefix(bool InGlobal) const
+const FString &USimpleSaveFile::GetSavingObjectPrefix(bool InGlobal) const
 {
 	static const FString String_Global = TEXT("![Global]:");
-	return InGlobal ? String_Global : FString::Printf(TEXT("!%s:"), *CurrentMapName.ToString());
+	if (InGlobal)
+	{
+		return String_Global;
+	}
+
+	//Built once per map instead of for every reference
+	if (LevelObjectPrefixMap != CurrentMapName || LevelObjectPrefix.Len() == 0)
+	{
+		LevelObjectPrefix = FString::Printf(TEXT("!%s:"), *CurrentMapName.ToString());
+		LevelObjectPrefixMap = CurrentMapName;
+	}
+
+	return LevelObjectPrefix;
 }
 
 //=================================================================
@@ -3123,21 +3994,39 @@ FString USimpleSaveFile::GetSavingObjectPrefix(bool InGlobal) const
 //=================================================================
 FString USimpleSaveFile::GetSavingObjectString(bool InGlobal, const FName &InTag, int32 InIndex) const
 {
-	return FString::Printf(TEXT("%s%d"), *GetSavingObjectPrefix(InGlobal), InIndex);
+	FString Result = GetSavingObjectPrefix(InGlobal);
+	Result.AppendInt(InIndex);
+	return Result;
 }
 
 //=================================================================
 // 
 //=================================================================
-FORCEINLINE static bool DoesReferenceString(const FCustomSaveData &InData, const FString &InString)
+void USimpleSaveFile::MarkReferencedObject(bool InGlobal, int32 InIndex)
 {
-	for (auto It = InData.Singles.CreateConstIterator(); It; ++It)
+	if (InGlobal || InIndex < 0)
+		return;
+
+	if (InIndex >= ReferencedLocalObjects.Num())
+	{
+		ReferencedLocalObjects.Add(false, InIndex + 1 - ReferencedLocalObjects.Num());
+	}
+
+	ReferencedLocalObjects[InIndex] = true;
+}
+
+//=================================================================
+// 
+//=================================================================
+FORCEINLINE static bool DoesReferenceString(const FCustomSaveData &InData, const TArray<FSimpleSaveData> &InPayloads, const FString &InString)
+{
+	for (auto It = InData.GetSingles(InPayloads).CreateConstIterator(); It; ++It)
 	{
 		if (It.Value().Equals(InString))
 			return true;
 	}
 
-	for (auto It = InData.Arrays.CreateConstIterator(); It; ++It)
+	for (auto It = InData.GetArrays(InPayloads).CreateConstIterator(); It; ++It)
 	{
 		for (int32 i=0; i<It.Value().Data.Num(); i++)
 		{
@@ -3146,7 +4035,7 @@ FORCEINLINE static bool DoesReferenceString(const FCustomSaveData &InData, const
 		}
 	}
 
-	for (auto It = InData.Maps.CreateConstIterator(); It; ++It)
+	for (auto It = InData.GetMaps(InPayloads).CreateConstIterator(); It; ++It)
 	{
 		for (auto It2 = It.Value().Data.CreateConstIterator(); It2; ++It2)
 		{
@@ -3163,11 +4052,13 @@ FORCEINLINE static bool DoesReferenceString(const FCustomSaveData &InData, const
 //=================================================================
 bool USimpleSaveFile::FindFirstReferenceTo(FString InString, FString& OutObjectThatReferences)
 {
+	WaitForLevelPacking();
+
 	for (int32 i=0; i<GlobalActors.Num(); i++)
 	{
 		const FActorSaveData &ActorData = GlobalActors.GetData()[i];
 
-		if (DoesReferenceString(ActorData.Custom, InString))
+		if (DoesReferenceString(ActorData.Custom, SharedPayloads, InString))
 		{
 			OutObjectThatReferences = GetSavingObjectString(true, ActorData.Custom.Tag, ActorData.Custom.ObjectIndex);
 			return true;
@@ -3178,7 +4069,7 @@ bool USimpleSaveFile::FindFirstReferenceTo(FString InString, FString& OutObjectT
 		{
 			const FComponentSaveData &ComponentData = ActorData.Components.GetData()[j];
 
-			if (DoesReferenceString(ComponentData.Custom, InString))
+			if (DoesReferenceString(ComponentData.Custom, SharedPayloads, InString))
 			{
 				OutObjectThatReferences = GetSavingObjectString(true, ActorData.Custom.Tag, ActorData.Custom.ObjectIndex) + TEXT(" - ") + GetSavingObjectString(true, ComponentData.Custom.Tag, ComponentData.Custom.ObjectIndex);
 				return true;
@@ -3190,7 +4081,7 @@ bool USimpleSaveFile::FindFirstReferenceTo(FString InString, FString& OutObjectT
 	{
 		const FCustomSaveData & Data = CustomObjects.GetData()[i];
 
-		if (DoesReferenceString(Data, InString))
+		if (DoesReferenceString(Data, SharedPayloads, InString))
 		{
 			OutObjectThatReferences = GetSavingObjectString(true, Data.Tag, Data.ObjectIndex);
 			return true;
@@ -3201,12 +4092,21 @@ bool USimpleSaveFile::FindFirstReferenceTo(FString InString, FString& OutObjectT
 	for (int32 k=0; k<Levels.Num(); k++)
 	{
 		const FLevelSaveData &LevelData = Levels.GetData()[k];
+		const TArray<FSimpleSaveData> &LevelPayloads = LevelData.SharedPayloads;
 
-		for (int32 i = 0; i < LevelData.Actors.Num(); i++)
+		//Packed levels are decoded one record at a time into these, the level itself stays packed
+		FActorSaveData PackedActor;
+		FCustomSaveData PackedObject;
+
+		const int32 iNumActors = LevelData.IsPacked() ? LevelData.PackedActors : LevelData.Actors.Num();
+		for (int32 i = 0; i < iNumActors; i++)
 		{
-			const FActorSaveData& ActorData = LevelData.Actors.GetData()[i];
+			if (LevelData.IsPacked() && !LevelData.GetPackedActor(i, PackedActor))
+				continue;
 
-			if (DoesReferenceString(ActorData.Custom, InString))
+			const FActorSaveData& ActorData = LevelData.IsPacked() ? PackedActor : LevelData.Actors.GetData()[i];
+
+			if (DoesReferenceString(ActorData.Custom, LevelPayloads, InString))
 			{
 				OutObjectThatReferences = GetSavingObjectString(false, ActorData.Custom.Tag, ActorData.Custom.ObjectIndex);
 				return true;
@@ -3217,7 +4117,7 @@ bool USimpleSaveFile::FindFirstReferenceTo(FString InString, FString& OutObjectT
 			{
 				const FComponentSaveData& ComponentData = ActorData.Components.GetData()[j];
 
-				if (DoesReferenceString(ComponentData.Custom, InString))
+				if (DoesReferenceString(ComponentData.Custom, LevelPayloads, InString))
 				{
 					OutObjectThatReferences = GetSavingObjectString(false, ActorData.Custom.Tag, ActorData.Custom.ObjectIndex) + TEXT(" - ") + GetSavingObjectString(false, ComponentData.Custom.Tag, ComponentData.Custom.ObjectIndex);
 					return true;
@@ -3225,11 +4125,15 @@ bool USimpleSaveFile::FindFirstReferenceTo(FString InString, FString& OutObjectT
 			}
 		}
 
-		for (int32 i = 0; i < LevelData.CustomObjects.Num(); i++)
+		const int32 iNumObjects = LevelData.IsPacked() ? LevelData.PackedOffsets.Num() - LevelData.PackedActors : LevelData.CustomObjects.Num();
+		for (int32 i = 0; i < iNumObjects; i++)
 		{
-			const FCustomSaveData& Data = LevelData.CustomObjects.GetData()[i];
+			if (LevelData.IsPacked() && !LevelData.GetPackedObject(i, PackedObject))
+				continue;
 
-			if (DoesReferenceString(Data, InString))
+			const FCustomSaveData& Data = LevelData.IsPacked() ? PackedObject : LevelData.CustomObjects.GetData()[i];
+
+			if (DoesReferenceString(Data, LevelPayloads, InString))
 			{
 				OutObjectThatReferences = GetSavingObjectString(false, Data.Tag, Data.ObjectIndex);
 				return true;
@@ -3317,6 +4221,7 @@ bool USimpleSaveFile::HandleSaveObject_Internal(class FProperty *InProperty, cla
 	if (GetObjectTag(pObject, Tag, iIndex, bGlobal))
 	{
 		OutString = GetSavingObjectString(bGlobal, Tag, iIndex);
+		MarkReferencedObject(bGlobal, iIndex);
 
 
 #if WITH_EDITOR
@@ -3340,6 +4245,7 @@ bool USimpleSaveFile::HandleSaveObject_Internal(class FProperty *InProperty, cla
 	if (pCurrent)
 	{
 		OutString = GetSavingObjectString(bGlobal, pCurrent->Tag, pCurrent->ObjectIndex);  
+		MarkReferencedObject(bGlobal, pCurrent->ObjectIndex);
 		
 #if WITH_EDITOR
 		if (bDebug)
@@ -3437,16 +4343,91 @@ bool USimpleSaveFile::HandleSaveObject_Internal(class FProperty *InProperty, cla
 
 	//Save a new object
 	OutString = GetSavingObjectString(bObjectIsGlobal, pData->Tag, pData->ObjectIndex);  
+	MarkReferencedObject(bObjectIsGlobal, pData->ObjectIndex);
 
 #if WITH_EDITOR
 	if (bDebug)
 	{
-		UE_LOG(LogTemp, Error, TEXT("HandleSaveObject_Internal [%s] Object \"%s\" with outer \"%s\" saving with tag \"%s\""), *InObject->GetName(), *pObject->GetName(), *pObject->GetOuter()->GetName(), *pData->Tag.ToString());
+		UE_LOG(LogTemp, Error, TEXT("HandleSaveObject_Internal [%s] Object \"%s\" with outer \"%s\" saving with tag \"%s\""), *InObject->GetName(), *pObject->GetName(), *pObject->GetOuter()->GetName(), *pData->GetTagString());
 	}
 #endif 
 	return true;
 }
 
+//=================================================================
+// Finds the next "Key=Value" pair of an exported struct without 
+// copying. Commas inside parentheses or quotes belong to the value.
+//=================================================================
+FORCEINLINE static bool GetNextStructMember(const FStringView &InValue, int32 &InOutPosition, FStringView &OutKey, FStringView &OutValue)
+{
+	const int32 iLen = InValue.Len();
+	const TCHAR *pData = InValue.GetData();
+
+	while (InOutPosition < iLen)
+	{
+		//Key runs until the first =
+		int32 iKeyStart = InOutPosition;
+		while (InOutPosition < iLen && pData[InOutPosition] != L'=')
+		{
+			InOutPosition++;
+		}
+
+		if (InOutPosition >= iLen)
+			return false;
+
+		OutKey = InValue.Mid(iKeyStart, InOutPosition - iKeyStart);
+		InOutPosition++;
+
+		//Value runs until a comma that is not nested or quoted
+		int32 iValueStart = InOutPosition;
+		int32 iParenthesis = 0;
+		bool bQuoted = false;
+		for (; InOutPosition < iLen; InOutPosition++)
+		{
+			const TCHAR Char = pData[InOutPosition];
+			if (bQuoted)
+			{
+				if (Char == L'\\')
+				{
+					InOutPosition++;
+				}
+				else if (Char == L'"')
+				{
+					bQuoted = false;
+				}
+				continue;
+			}
+
+			if (Char == L'"')
+			{
+				bQuoted = true;
+			}
+			else if (Char == L'(')
+			{
+				iParenthesis++;
+			}
+			else if (Char == L')')
+			{
+				iParenthesis--;
+			}
+			else if (Char == L',' && iParenthesis == 0)
+			{
+				break;
+			}
+		}
+
+		OutValue = InValue.Mid(iValueStart, FMath::Min(InOutPosition, iLen) - iValueStart);
+
+		//Skip the comma
+		InOutPosition++;
+
+		if (OutKey.Len() > 0)
+			return true;
+	}
+
+	return false;
+}
+
 //=================================================================
 // 
 //=================================================================
@@ -3490,86 +4471,39 @@ bool USimpleSaveFile::HandleRestoreStruct(class USimpleSaveFile *InFile, class F
 
 	int32 PortFlags = PPF_SimpleObjectText;
 
-	FString NewValue = InValue.Mid(1, iLen-2);
-	iLen = iLen-2;
+	//Members are parsed straight out of the saved string, only values are
+	//copied into a stack buffer because ImportText expects a terminated string
+	const FStringView Members = FStringView(InValue).Mid(1, iLen-2);
+	const FSimpleSaveClassLayout *pLayout = GetClassLayout(InFile, StructProperty->Struct);
+	TStringBuilder<256> Value;
 
-	TMap<FName, FString> KeyAndValue;
-	bool bParsingKey = true;
-
-	FString CurrentKey;
-	FString CurrentValue;
-	int32 iParenthesis = 0;
-
-	//Go through all the whole value
-	for (int32 i=0; i<iLen; i++)
+	int32 iPosition = 0;
+	FStringView Key;
+	FStringView ValueView;
+	while (GetNextStructMember(Members, iPosition, Key, ValueView))
 	{
-		//If we need to stop parsing the key
-		if (bParsingKey && NewValue[i] == L'=')
-		{
-			bParsingKey = false;
-			continue;
-		}
+		//Finding the name is enough, a name that does not exist can't be a property
+		FName KeyName(Key.Len(), Key.GetData(), FNAME_Find);
 
-		//If we need to stop parsing the value
-		if (!bParsingKey && iParenthesis == 0 && NewValue[i] == L',')
-		{
-			if (CurrentKey.Len() > 0)
-			{
-				KeyAndValue.Emplace(*CurrentKey, CurrentValue);
-			}
-
-			CurrentKey = TEXT("");
-			CurrentValue = TEXT("");
-			bParsingKey = true;
-			continue;
-		}
-
-		if (!bParsingKey && NewValue[i] == L'(')
-		{
-			iParenthesis++;
-		}
-
-		if (!bParsingKey && NewValue[i] == L')')
-		{
-			iParenthesis--;
-		}
-
-		if (bParsingKey)
-		{
-			CurrentKey += NewValue[i];
-		}
-		else
-		{
-			CurrentValue += NewValue[i];
-		}
-	}
-
-	if (CurrentKey.Len() > 0)
-	{
-		KeyAndValue.Emplace(*CurrentKey, CurrentValue);
-	}
-
-	//
-	for (auto It = KeyAndValue.CreateConstIterator(); It; ++It)
-	{
-		class FProperty *Property = FindFProperty<FProperty>(StructProperty->Struct, It.Key());
+		class FProperty *Property = KeyName.IsNone() ? NULL : FindRestoreProperty(pLayout, StructProperty->Struct, KeyName);
 		if (Property)
 		{
-			FString Value = It.Value();
 			void *ValuePtr = Property->ContainerPtrToValuePtr<void>(InRawData);
 
-			if (HandleRestoreObject(InFile, Property, Value, ValuePtr, 0, InObject))
+			if (HandleRestoreObject(InFile, Property, ValueView, ValuePtr, 0, InObject))
 			{
 				continue;
 			}
 
-			HandleFixSoftObject(InObject, InProperty, Value);
+			Value.Reset();
+			Value.Append(ValueView);
 
-			Property->ImportText_Direct(*Value, ValuePtr, InObject, PortFlags);
+			//Nested structs are handed to ImportText as they are, it parses them in place
+			Property->ImportText_Direct(Value.ToString(), ValuePtr, InObject, PortFlags);
 		}
 		else
 		{
-			UE_LOG(LogTemp, Error, TEXT("Failing to restore key \"%s\" value \"%s\" in struct \"%s\""), *It.Key().ToString(), *It.Value(), *StructProperty->Struct->GetName());
+			UE_LOG(LogTemp, Error, TEXT("Failing to restore key \"%s\" value \"%s\" in struct \"%s\""), *FString(Key), *FString(ValueView), *StructProperty->Struct->GetName());
 		}
 	}
 
@@ -3577,52 +4511,93 @@ bool USimpleSaveFile::HandleRestoreStruct(class USimpleSaveFile *InFile, class F
 }
 
 //=================================================================
-// 
+// Points a saved object path to the current world, writes the
+// fixed path to OutValue only when something needs fixing
 //=================================================================
-bool USimpleSaveFile::HandleFixSoftObject(class UObject *InObject, class FProperty *InProperty, FString &InValue) 
+bool USimpleSaveFile::HandleFixSoftObject(class USimpleSaveFile *InFile, class UObject *InObject, const FStringView &InValue, FString &OutValue) 
 {
 	if (InValue.Len() == 0)
 		return false;
 
-	if (InProperty != NULL)
+	int32 iColon = INDEX_NONE;
+	if (!InValue.FindLastChar(L':', iColon))
+		return false;
+
+	if (InFile != NULL && InFile->RestoreWorldPath.Len() > 0)
 	{
-		FObjectPropertyBase *pBase = CastField<FObjectPropertyBase>(InProperty);
-		if (!pBase)
-			return false;
+		OutValue = InFile->RestoreWorldPath;
+	}
+	else
+	{
+		OutValue = InObject->GetWorld()->GetPathName();
+	}
 
-			
-		FSoftObjectProperty* SoftObjectProperty = CastField<FSoftObjectProperty>(InProperty);
-		/*
-		if (!SoftObjectProperty && pBase->PropertyClass != NULL && pBase->PropertyClass->IsChildOf(AActor::StaticClass()))
-		{
-			UE_LOG(LogTemp, Error, TEXT("Hard reference to actor %s in property %s"), *InValue, *InProperty->GetName());
-		}
-		*/
+	OutValue.Append(InValue.RightChop(iColon));
+	return true;
+}
 
-		/*
-		FSoftObjectProperty *SoftObjectProperty = CastField<FSoftObjectProperty>(InProperty);
-		if (!SoftObjectProperty)
-			return false;
-			*/
-		
+//=================================================================
+// 
+//=================================================================
+void USimpleSaveFile::RestoreValue(class USimpleSaveFile *InFile, class FProperty *InProperty, const FString &InValue, void *InRawData, class UObject *InObject)
+{
+	int32 TextPortFlags = PPF_SimpleObjectText;
+
+	if (HandleRestoreObject(InFile, InProperty, InValue, InRawData, 0, InObject))
+		return;
+
+	if (HandleRestoreStruct(InFile, InProperty, InValue, InRawData, 0, InObject))
+		return;
+
+	//Object paths may point to the world they were saved in
+	FString FixedValue;
+	if (CastField<FObjectPropertyBase>(InProperty) != NULL && HandleFixSoftObject(InFile, InObject, InValue, FixedValue))
+	{
+		InProperty->ImportText_Direct(*FixedValue, InRawData, InObject, TextPortFlags);
+		return;
 	}
 
+	InProperty->ImportText_Direct(*InValue, InRawData, InObject, TextPortFlags);
+}
+
+//=================================================================
+// Reads the index after a saved object prefix
+//=================================================================
+FORCEINLINE static bool ParseSavedObjectIndex(const FStringView &InValue, int32 InStart, int32 &OutIndex)
+{
+	const int32 iLen = InValue.Len();
+	if (InStart >= iLen)
+		return false;
 
-	FString ObjectPointer;
-	if (InValue.Split(TEXT(":"), NULL, &ObjectPointer, ESearchCase::IgnoreCase, ESearchDir::FromEnd))
+	//More digits could wrap around to an index that looks valid
+	if (iLen - InStart > 9)
+		return false;
+
+	int32 iIndex = 0;
+	for (int32 i=InStart; i<iLen; i++)
 	{
-		InValue = InObject->GetWorld()->GetPathName() + TEXT(":") + ObjectPointer;
-		return true;
+		const TCHAR Char = InValue[i];
+		if (Char < L'0' || Char > L'9')
+			return false;
+
+		iIndex = iIndex * 10 + (Char - L'0');
 	}
 
-	return false;
+	OutIndex = iIndex;
+	return true;
 }
 
 //=================================================================
 // 
 //=================================================================
-bool USimpleSaveFile::HandleRestoreObject_Internal(class FProperty *InProperty, const FString &InValue, void *InRawData, int32 InIndex, class UObject *InObject)
+bool USimpleSaveFile::HandleRestoreObject_Internal(class FProperty *InProperty, const FStringView &InValue, void *InRawData, int32 InIndex, class UObject *InObject)
 {
+	//All saved references start with !
+	if (InValue.Len() < 2 || InValue[0] != L'!')
+	{
+		return false;
+	}
+
 	//Check that object property
 	class FObjectPropertyBase *ObjectProperty = CastField<FObjectPropertyBase>(InProperty); // CastToObjectProperty(InProperty);
 	if (!ObjectProperty)
@@ -3630,22 +4605,32 @@ bool USimpleSaveFile::HandleRestoreObject_Internal(class FProperty *InProperty,
 		return false;
 	}
 
-	FString Number;
+	const FString &GlobalPrefix = GetSavingObjectPrefix(true);
+	const FString &LevelPrefix = GetSavingObjectPrefix(false);
+	const FString &SoftPrefix = GetSoftObjectPrefix();
+
+	int32 iIndex = INDEX_NONE;
 	bool bSuccess = false;
 	bool bGlobal = false;
-	if (InValue.Split(GetSavingObjectPrefix(true), NULL, &Number))
+	if (InValue.StartsWith(GlobalPrefix, ESearchCase::IgnoreCase))
 	{
-		bSuccess = true;
+		bSuccess = ParseSavedObjectIndex(InValue, GlobalPrefix.Len(), iIndex);
 		bGlobal = true;
 	}
-	else if (InValue.Split(GetSavingObjectPrefix(false), NULL, &Number))
+	else if (InValue.StartsWith(LevelPrefix, ESearchCase::IgnoreCase))
 	{
-		bSuccess = true;
+		bSuccess = ParseSavedObjectIndex(InValue, LevelPrefix.Len(), iIndex);
 		bGlobal = false;
 	}
-	else if (InValue.Split(GetSoftObjectPrefix(), NULL, &Number))
+	else if (InValue.StartsWith(SoftPrefix, ESearchCase::IgnoreCase))
 	{
-		HandleFixSoftObject(InObject, NULL, Number);
+		const FStringView SoftPath = InValue.RightChop(SoftPrefix.Len());
+
+		FString Number;
+		if (!HandleFixSoftObject(this, InObject, SoftPath, Number))
+		{
+			Number = FString(SoftPath);
+		}
 
 		/*
 		const FSoftObjectProperty *SoftObjectProperty = CastField<FSoftObjectProperty>(InProperty);
@@ -3685,13 +4670,13 @@ bool USimpleSaveFile::HandleRestoreObject_Internal(class FProperty *InProperty,
 #endif //
 
 	//If we succeeded
-	if (bSuccess && Number.Len() > 0)
+	if (bSuccess)
 	{
 		const TArray<class UObject*> &SaveObjects = bGlobal ? GlobalSaveObjects : LocalSaveObjects;
 
-		int32 iIndex = FCString::Atoi(*Number);
 		if (!SaveObjects.IsValidIndex(iIndex))
 		{
+			UnresolvedObjectReferences++;
 #if WITH_EDITOR
 			if (bDebug)
 			{
@@ -3701,9 +4686,12 @@ bool USimpleSaveFile::HandleRestoreObject_Internal(class FProperty *InProperty,
 			return false;
 		}
 
+		class UObject *pObject = SaveObjects.GetData()[iIndex];
+
 		//Sanity check
-		if (!IsValid(SaveObjects.GetData()[iIndex]))
+		if (!IsValid(pObject))
 		{
+			UnresolvedObjectReferences++;
 #if WITH_EDITOR
 			if (bDebug)
 			{
@@ -3714,8 +4702,9 @@ bool USimpleSaveFile::HandleRestoreObject_Internal(class FProperty *InProperty,
 		}
 
 		//Sanity check
-		if (SaveObjects.GetData()[iIndex]->GetClass() == NULL)
+		if (pObject->GetClass() == NULL)
 		{
+			UnresolvedObjectReferences++;
 #if WITH_EDITOR
 			if (bDebug)
 			{
@@ -3725,25 +4714,26 @@ bool USimpleSaveFile::HandleRestoreObject_Internal(class FProperty *InProperty,
 			return false;
 		}
 		
-		//Check that correct class
-		if (!SaveObjects.GetData()[iIndex]->GetClass()->IsChildOf(ObjectProperty->PropertyClass))
+		//Not the object it will be yet, left for the next pass instead of binding the wrong type
+		if (!pObject->GetClass()->IsChildOf(ObjectProperty->PropertyClass))
 		{
+			UnresolvedObjectReferences++;
 #if WITH_EDITOR
 			if (bDebug)
 			{
-				UE_LOG(LogTemp, Error, TEXT("HandleRestoreObject_Internal [%s] Property \"%s\" Invalid class %s does not match %s"), *InObject->GetName(), *ObjectProperty->GetName(), *SaveObjects.GetData()[iIndex]->GetClass()->GetName(), *ObjectProperty->PropertyClass->GetName());
+				UE_LOG(LogTemp, Error, TEXT("HandleRestoreObject_Internal [%s] Property \"%s\" Invalid class %s does not match %s"), *InObject->GetName(), *ObjectProperty->GetName(), *pObject->GetClass()->GetName(), *ObjectProperty->PropertyClass->GetName());
 			}
 #endif //
 			return false;
 		}
 
 		//Restore the value
-		ObjectProperty->SetObjectPropertyValue(InRawData, SaveObjects.GetData()[iIndex]);
+		ObjectProperty->SetObjectPropertyValue(InRawData, pObject);
 
 #if WITH_EDITOR
 		if (bDebug)
 		{
-			UE_LOG(LogTemp, Display, TEXT("HandleRestoreObject_Internal [%s] Restoring Property \"%s\" to \"%s\""), *InObject->GetName(), *ObjectProperty->GetName(), *SaveObjects.GetData()[iIndex]->GetName());
+			UE_LOG(LogTemp, Display, TEXT("HandleRestoreObject_Internal [%s] Restoring Property \"%s\" to \"%s\""), *InObject->GetName(), *ObjectProperty->GetName(), *pObject->GetName());
 		}
 #endif //
 		return true;
@@ -3771,6 +4761,17 @@ FORCEINLINE static bool IsSimpleProperty(const FProperty *InProperty)
 	return true;
 }
 
+//=================================================================
+// Exports into a reused buffer so the saved string is allocated
+// once at its final size instead of growing while exporting
+//=================================================================
+FORCEINLINE static void ExportSaveValue(class FProperty *InProperty, void *InValuePtr, class UObject *InObject, int32 InPortFlags, FString &InScratch, FString &OutString)
+{
+	InScratch.Reset();
+	InProperty->ExportTextItem_Direct(InScratch, InValuePtr, InValuePtr, InObject, InPortFlags);
+	OutString = FString(InScratch.Len(), *InScratch);
+}
+
 //=================================================================
 // 
 //=================================================================
@@ -3784,6 +4785,19 @@ void USimpleSaveFile::SaveCustomData_Internal(class USimpleSaveFile *InFile, cla
 	Arrays.Reset();
 	Maps.Reset();
 
+	//Size the record from the class so it isn't grown value by value
+	const FSimpleSaveClassLayout *pLayout = GetClassLayout(InFile, InObject->GetClass());
+	if (pLayout)
+	{
+		Singles.Reserve(pLayout->Singles.Num());
+		Arrays.Reserve(pLayout->Arrays.Num());
+		Maps.Reserve(pLayout->Maps.Num());
+	}
+
+	//The file keeps its buffer between saves
+	FString LocalScratch;
+	FString &Scratch = InFile != NULL ? InFile->ExportScratch : LocalScratch;
+
 	int32 TextPortFlags = PPF_SimpleObjectText;
 
 	//Go through all the properties
@@ -3817,21 +4831,21 @@ void USimpleSaveFile::SaveCustomData_Internal(class USimpleSaveFile *InFile, cla
 				continue;
 
 			FArrayData NewArray;
-			NewArray.Data.SetNum(0);
 
 			FScriptArrayHelper_InContainer ArrayHelper(ArrayProperty, InObject);
+			NewArray.Data.Reserve(ArrayHelper.Num());
 			for (int32 i = 0; i < ArrayHelper.Num(); i++)
 			{
 				FString NewElement;
 				if (!HandleSaveObject(InFile, ArrayProperty->Inner, InObject, ArrayHelper.GetRawPtr(i), 0, NewElement) && !HandleSaveStruct(InFile, ArrayProperty->Inner, InObject, ArrayHelper.GetRawPtr(i), NewElement))
 				{
-					ArrayProperty->Inner->ExportTextItem_Direct(NewElement, ArrayHelper.GetRawPtr(i), ArrayHelper.GetRawPtr(i), InObject, TextPortFlags);		
+					ExportSaveValue(ArrayProperty->Inner, ArrayHelper.GetRawPtr(i), InObject, TextPortFlags, Scratch, NewElement);
 				}
 
-				NewArray.Data.Add(NewElement);
+				NewArray.Data.Add(MoveTemp(NewElement));
 			}
 
-			Arrays.Emplace(Property->GetFName(), NewArray);
+			Arrays.Emplace(Property->GetFName(), MoveTemp(NewArray));
 			continue;
 		}
 
@@ -3852,9 +4866,9 @@ void USimpleSaveFile::SaveCustomData_Internal(class USimpleSaveFile *InFile, cla
 				continue;
 
 			FMapData NewMap;
-			NewMap.Data.Empty();
 
 			FScriptMapHelper_InContainer MapHelper(MapProperty, InObject, 0); 
+			NewMap.Data.Reserve(MapHelper.Num());
 
 			for (int32 SparseElementIndex = 0; SparseElementIndex < MapHelper.GetMaxIndex(); ++SparseElementIndex)
 			{
@@ -3867,21 +4881,21 @@ void USimpleSaveFile::SaveCustomData_Internal(class USimpleSaveFile *InFile, cla
 					if (!HandleSaveObject(InFile, MapHelper.GetKeyProperty(), InObject, MapHelper.GetKeyPtr(SparseElementIndex), 0, Key) &&
 						!HandleSaveStruct(InFile, MapHelper.GetKeyProperty(), InObject, MapHelper.GetKeyPtr(SparseElementIndex), Key))
 					{
-						MapHelper.GetKeyProperty()->ExportTextItem_Direct(Key, MapHelper.GetKeyPtr(SparseElementIndex), MapHelper.GetKeyPtr(SparseElementIndex), InObject, TextPortFlags);
+						ExportSaveValue(MapHelper.GetKeyProperty(), MapHelper.GetKeyPtr(SparseElementIndex), InObject, TextPortFlags, Scratch, Key);
 					}
 
 					//Save value
 					if (!HandleSaveObject(InFile, MapHelper.GetValueProperty(), InObject, MapHelper.GetValuePtr(SparseElementIndex), 0, Value) &&
 						!HandleSaveStruct(InFile, MapHelper.GetValueProperty(), InObject, MapHelper.GetValuePtr(SparseElementIndex), Value))
 					{
-						MapHelper.GetValueProperty()->ExportTextItem_Direct(Value, MapHelper.GetValuePtr(SparseElementIndex), MapHelper.GetValuePtr(SparseElementIndex), InObject, TextPortFlags);
+						ExportSaveValue(MapHelper.GetValueProperty(), MapHelper.GetValuePtr(SparseElementIndex), InObject, TextPortFlags, Scratch, Value);
 					}
 
-					NewMap.Data.Emplace( Key, Value );		
+					NewMap.Data.Emplace( MoveTemp(Key), MoveTemp(Value) );		
 				}
 			}
 
-			Maps.Emplace(Property->GetFName(), NewMap);
+			Maps.Emplace(Property->GetFName(), MoveTemp(NewMap));
 			continue;
 		}
 
@@ -3898,7 +4912,7 @@ void USimpleSaveFile::SaveCustomData_Internal(class USimpleSaveFile *InFile, cla
 				continue;
 
 			FArrayData NewArray;
-			NewArray.Data.SetNum(0);
+			NewArray.Data.Reserve(Property->ArrayDim);
 
 			for (int32 Index = 0; Index < Property->ArrayDim; Index++)
 			{
@@ -3908,13 +4922,13 @@ void USimpleSaveFile::SaveCustomData_Internal(class USimpleSaveFile *InFile, cla
 				FString SaveString;
 				if (!HandleSaveObject(InFile, *Property, InObject, ValuePtr, 0, SaveString) && !HandleSaveStruct(InFile, *Property, InObject, ValuePtr, SaveString))
 				{
-					Property->ExportTextItem_Direct(SaveString, ValuePtr, ValuePtr, InObject, TextPortFlags);
+					ExportSaveValue(*Property, ValuePtr, InObject, TextPortFlags, Scratch, SaveString);
 				}
 
-				NewArray.Data.Add(SaveString);
+				NewArray.Data.Add(MoveTemp(SaveString));
 			}
 
-			Arrays.Emplace(Property->GetFName(), NewArray);
+			Arrays.Emplace(Property->GetFName(), MoveTemp(NewArray));
 		}
 		//Regular gosh darn variable
 		else
@@ -3953,7 +4967,7 @@ void USimpleSaveFile::SaveCustomData_Internal(class USimpleSaveFile *InFile, cla
 			}
 			else
 			{
-				Property->ExportTextItem_Direct(SaveString, ValuePtr, ValuePtr, InObject, TextPortFlags);
+				ExportSaveValue(*Property, ValuePtr, InObject, TextPortFlags, Scratch, SaveString);
 
 #if WITH_EDITOR
 				class FObjectPropertyBase *pObjectProperty = bDebug ? CastField<FObjectPropertyBase>(*Property) : NULL;
@@ -3964,91 +4978,423 @@ void USimpleSaveFile::SaveCustomData_Internal(class USimpleSaveFile *InFile, cla
 #endif //
 			}
 
-			Singles.Emplace(Property->GetFName(), SaveString);
-		}
+			Singles.Emplace(Property->GetFName(), MoveTemp(SaveString));
+		}
+	}
+
+	//
+	if (InFile)
+	{
+		class ISaveInterface *pInterface = Cast<ISaveInterface>(InObject);
+		if (pInterface)
+		{
+			TArray<class UObject*> Assets;
+			pInterface->GetCustomAssetsToLoad(Assets);
+			for (int32 i=0; i<Assets.Num(); i++)
+			{
+				if (IsValid(Assets.GetData()[i]) && ShouldSaveIntoAssetArray(Assets.GetData()[i]))
+				{
+					InFile->AssetsToLoad.AddUnique(Assets.GetData()[i]);
+				}
+			}
+		}
+	}
+
+#if WITH_EDITOR
+	if (bDebug)
+	{
+		for (auto It = Singles.CreateConstIterator(); It; ++It)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Property \"%s\" value \"%s\""), *It.Key().ToString(), *It.Value());
+		}
+	}
+#endif 
+}
+
+//=================================================================
+// 
+//=================================================================
+bool USimpleSaveFile::SaveCustomData(class UObject *InObject, FCustomSaveData &InData)
+{
+	if (!IsValid(InObject))
+	{
+		UE_LOG(LogTemp, Fatal, TEXT("Null object on SaveCustomData!"));
+		return false;
+	}
+
+	InData.Class = InObject->GetClass();
+	InData.Name = InObject->GetFName();
+	InData.OuterObjectIndex = INDEX_NONE;
+
+	if (InData.ObjectIndex == INDEX_NONE)
+	{
+		UE_LOG(LogTemp, Fatal, TEXT("Invalid object index!"));
+	}
+
+	ISaveInterface *pInterface = Cast<ISaveInterface>(InObject);
+    if (pInterface)
+    {
+		pInterface->Runtime_PreSave();
+
+		InData.Recreate = pInterface->ShouldDeleteOnRestore();
+	}
+	else
+	{
+		InData.Recreate = false;
+	}
+
+	SaveCustomData_Internal(this, InObject, InData.Singles, InData.Arrays, InData.Maps);
+	InData.SchemaHash = GetClassLayout(InObject->GetClass())->SchemaHash;
+
+	if (pInterface)
+    {
+		pInterface->Runtime_PostSave();
+	}
+
+	return InData.GetCount() > 0;
+}
+
+//=================================================================
+// 
+//=================================================================
+void USimpleSaveFile::SaveSimpleProperties(class UObject *InObject, FSimpleSaveData &InData, bool InIgnoreNativeProperties)
+{
+	InData.Singles.Reset();
+	InData.Arrays.Reset();
+	InData.Maps.Reset();
+
+	SaveCustomData_Internal(NULL, InObject, InData.Singles, InData.Arrays, InData.Maps, true, NULL, InIgnoreNativeProperties);
+}
+
+//=================================================================
+// 
+//=================================================================
+void USimpleSaveFile::SaveBaselineProperties(class UObject *InObject, FSimpleSaveData &OutData)
+{
+	SaveCustomData_Internal(NULL, InObject, OutData.Singles, OutData.Arrays, OutData.Maps);
+}
+
+//=================================================================
+// Removes values that are the same as when the level was loaded,
+// a restore leaves those properties to their loaded values
+//=================================================================
+FORCEINLINE static void PruneUnchangedValues(FCustomSaveData &InData, const FSimpleSaveData &InBaseline)
+{
+	bool bPruned = false;
+
+	for (auto It = InData.Singles.CreateIterator(); It; ++It)
+	{
+		const FString *pBaseline = InBaseline.Singles.Find(It.Key());
+		if (pBaseline && pBaseline->Equals(It.Value(), ESearchCase::CaseSensitive))
+		{
+			It.RemoveCurrent();
+			bPruned = true;
+		}
+	}
+
+	for (auto It = InData.Arrays.CreateIterator(); It; ++It)
+	{
+		const FArrayData *pBaseline = InBaseline.Arrays.Find(It.Key());
+		if (pBaseline && pBaseline->Data == It.Value().Data)
+		{
+			It.RemoveCurrent();
+			bPruned = true;
+		}
+	}
+
+	for (auto It = InData.Maps.CreateIterator(); It; ++It)
+	{
+		const FMapData *pBaseline = InBaseline.Maps.Find(It.Key());
+		if (pBaseline && pBaseline->Data.OrderIndependentCompareEqual(It.Value().Data))
+		{
+			It.RemoveCurrent();
+			bPruned = true;
+		}
+	}
+
+	//Positions no longer match the class
+	if (bPruned)
+	{
+		InData.SchemaHash = 0;
+	}
+}
+
+//=================================================================
+// Delta saving drops the records of placed actors that match the
+// loaded level, restoring still has to call the interface on them
+//=================================================================
+void USimpleSaveFile::GatherUnchangedPlacedObjects(class UObject *WorldContext)
+{
+	UnchangedPlacedObjects.Reset();
+
+	if (!CurrentLevelData || !CurrentLevelData->DeltaSaved)
+		return;
+
+	TSet<const class UObject*> Saved;
+	Saved.Reserve(LocalSaveObjects.Num());
+	for (int32 i=0; i<LocalSaveObjects.Num(); i++)
+	{
+		Saved.Add(LocalSaveObjects.GetData()[i]);
+	}
+
+	TArray<class AActor*> AllActors;
+	UGameplayStatics::GetAllActorsWithInterface(WorldContext, USaveInterface::StaticClass(), AllActors);
+
+	for (int32 i=0; i<AllActors.Num(); i++)
+	{
+		class AActor *pActor = AllActors.GetData()[i];
+
+		//Same actors the baseline is taken from
+		ISaveInterface *pInterface = Cast<ISaveInterface>(pActor);
+		if (!pInterface || !pInterface->ShouldSave() || pInterface->ShouldDeleteOnRestore() || IsMarkedForDestruction(pActor))
+			continue;
+
+		if (!Saved.Contains(pActor))
+		{
+			UnchangedPlacedObjects.Add(pActor);
+		}
+
+		TArray<class UActorComponent*> Components;
+		pActor->GetComponents(Components);
+		for (int32 j=0; j<Components.Num(); j++)
+		{
+			if (Cast<ISaveInterface>(Components.GetData()[j]) && !Saved.Contains(Components.GetData()[j]))
+			{
+				UnchangedPlacedObjects.Add(Components.GetData()[j]);
+			}
+		}
+	}
+
+	for (int32 i=0; i<UnchangedPlacedObjects.Num(); i++)
+	{
+		PreRestoreCalled.Add(UnchangedPlacedObjects.GetData()[i]);
+		Cast<ISaveInterface>(UnchangedPlacedObjects.GetData()[i])->PreRestore();
+	}
+}
+
+//=================================================================
+// Object references are saved from this file and never match the
+// baseline, so anything that points to another object stays
+//=================================================================
+void USimpleSaveFile::PruneUnchangedLocalRecords(class USaveGameInstance *InInstance)
+{
+	if (!CurrentLevelData)
+		return;
+
+	CurrentLevelData->DeltaSaved = !KeepUnchangedRecords && InInstance->UseDeltaSaving() && InInstance->HasLevelBaseline(CurrentLevelData->LevelName);
+	if (!CurrentLevelData->DeltaSaved)
+		return;
+
+	//Records that other records point to have to stay
+	TBitArray<> Keep = ReferencedLocalObjects;
+	if (Keep.Num() < LocalSaveObjects.Num())
+	{
+		Keep.Add(false, LocalSaveObjects.Num() - Keep.Num());
+	}
+
+	for (int32 i=0; i<CurrentLevelData->CustomObjects.Num(); i++)
+	{
+		const FCustomSaveData &Data = CurrentLevelData->CustomObjects.GetData()[i];
+		if (!Data.OuterIsGlobal && Keep.IsValidIndex(Data.OuterObjectIndex))
+		{
+			Keep[Data.OuterObjectIndex] = true;
+		}
+	}
+
+	for (int32 i=0; i<CurrentLevelData->Actors.Num(); i++)
+	{
+		const FCustomSaveData &Data = CurrentLevelData->Actors.GetData()[i].Custom;
+		if (!Data.OuterIsGlobal && Keep.IsValidIndex(Data.OuterObjectIndex))
+		{
+			Keep[Data.OuterObjectIndex] = true;
+		}
+	}
+
+	for (int32 i=0; i<GlobalActors.Num(); i++)
+	{
+		const FCustomSaveData &Data = GlobalActors.GetData()[i].Custom;
+		if (!Data.OuterIsGlobal && Keep.IsValidIndex(Data.OuterObjectIndex))
+		{
+			Keep[Data.OuterObjectIndex] = true;
+		}
+	}
+
+	int32 iRemoved = 0;
+	for (int32 i=CurrentLevelData->Actors.Num()-1; i>=0; i--)
+	{
+		FActorSaveData &ActorData = CurrentLevelData->Actors.GetData()[i];
+		class AActor *pActor = Cast<AActor>(GetRestoreObjectIndex(ActorData.Custom.ObjectIndex, false));
+
+		const FSimpleLevelBaseline *pBaseline = InInstance->FindLevelBaseline(pActor);
+		if (!pBaseline || ActorData.Custom.Recreate)
+			continue;
+
+		PruneUnchangedValues(ActorData.Custom, pBaseline->Data);
+
+		for (int32 j=ActorData.Components.Num()-1; j>=0; j--)
+		{
+			FComponentSaveData &ComponentData = ActorData.Components.GetData()[j];
+			const FSimpleLevelBaseline *pComponentBaseline = InInstance->FindLevelBaseline(GetRestoreObjectIndex(ComponentData.Custom.ObjectIndex, false));
+			if (!pComponentBaseline)
+				continue;
+
+			PruneUnchangedValues(ComponentData.Custom, pComponentBaseline->Data);
+
+			if (ComponentData.Custom.GetCount() == 0 && !Keep[ComponentData.Custom.ObjectIndex] && ComponentData.Transform.Equals(pComponentBaseline->Transform))
+			{
+				ActorData.Components.RemoveAt(j);
+			}
+		}
+
+		//Tagged actors are looked up by tag on restore so their records always stay
+		if (ActorData.Custom.GetCount() == 0 && ActorData.Components.Num() == 0 && ActorData.Custom.Tag.IsNone() && 
+			ActorData.Custom.OuterObjectIndex == INDEX_NONE && !Keep[ActorData.Custom.ObjectIndex] && ActorData.Transform.Equals(pBaseline->Transform))
+		{
+			CurrentLevelData->Actors.RemoveAt(i);
+			iRemoved++;
+		}
+	}
+
+	UE_LOG(LogTemp, Verbose, TEXT("Delta saving left out %d unchanged actors"), iRemoved);
+}
+
+//=================================================================
+// Records of the same class are written in the same order so the
+// values can be hashed and compared in order
+//=================================================================
+FORCEINLINE static uint32 HashRecordValues(const FCustomSaveData &InData)
+{
+	uint32 iHash = HashCombine(GetTypeHash(InData.Class), GetTypeHash(InData.SchemaHash));
+
+	for (auto It = InData.Singles.CreateConstIterator(); It; ++It)
+	{
+		iHash = HashCombine(iHash, HashCombine(GetTypeHash(It.Key()), GetTypeHash(It.Value())));
 	}
 
-	//
-	if (InFile)
+	for (auto It = InData.Arrays.CreateConstIterator(); It; ++It)
 	{
-		class ISaveInterface *pInterface = Cast<ISaveInterface>(InObject);
-		if (pInterface)
+		iHash = HashCombine(iHash, GetTypeHash(It.Key()));
+		for (int32 i=0; i<It.Value().Data.Num(); i++)
 		{
-			TArray<class UObject*> Assets;
-			pInterface->GetCustomAssetsToLoad(Assets);
-			for (int32 i=0; i<Assets.Num(); i++)
-			{
-				if (IsValid(Assets.GetData()[i]) && ShouldSaveIntoAssetArray(Assets.GetData()[i]))
-				{
-					InFile->AssetsToLoad.AddUnique(Assets.GetData()[i]);
-				}
-			}
+			iHash = HashCombine(iHash, GetTypeHash(It.Value().Data.GetData()[i]));
 		}
 	}
 
-#if WITH_EDITOR
-	if (bDebug)
+	for (auto It = InData.Maps.CreateConstIterator(); It; ++It)
 	{
-		for (auto It = Singles.CreateConstIterator(); It; ++It)
+		iHash = HashCombine(iHash, GetTypeHash(It.Key()));
+		for (auto It2 = It.Value().Data.CreateConstIterator(); It2; ++It2)
 		{
-			UE_LOG(LogTemp, Error, TEXT("Property \"%s\" value \"%s\""), *It.Key().ToString(), *It.Value());
+			iHash = HashCombine(iHash, HashCombine(GetTypeHash(It2.Key()), GetTypeHash(It2.Value())));
 		}
 	}
-#endif 
+
+	return iHash;
 }
 
 //=================================================================
-// 
+// String hashes ignore case so the values are compared here
 //=================================================================
-bool USimpleSaveFile::SaveCustomData(class UObject *InObject, FCustomSaveData &InData)
+FORCEINLINE static bool AreRecordValuesEqual(const FCustomSaveData &InA, const FCustomSaveData &InB)
 {
-	if (!IsValid(InObject))
-	{
-		UE_LOG(LogTemp, Fatal, TEXT("Null object on SaveCustomData!"));
+	if (InA.Class != InB.Class || InA.SchemaHash != InB.SchemaHash || 
+		InA.Singles.Num() != InB.Singles.Num() || InA.Arrays.Num() != InB.Arrays.Num() || InA.Maps.Num() != InB.Maps.Num())
 		return false;
-	}
-
-	InData.Class = InObject->GetClass();
-	InData.Name = InObject->GetFName();
-	InData.OuterObjectIndex = INDEX_NONE;
 
-	if (InData.ObjectIndex == INDEX_NONE)
+	for (auto ItA = InA.Singles.CreateConstIterator(), ItB = InB.Singles.CreateConstIterator(); ItA; ++ItA, ++ItB)
 	{
-		UE_LOG(LogTemp, Fatal, TEXT("Invalid object index!"));
+		if (ItA.Key() != ItB.Key() || !ItA.Value().Equals(ItB.Value(), ESearchCase::CaseSensitive))
+			return false;
 	}
 
-	ISaveInterface *pInterface = Cast<ISaveInterface>(InObject);
-    if (pInterface)
-    {
-		pInterface->Runtime_PreSave();
-
-		InData.Recreate = pInterface->ShouldDeleteOnRestore();
-	}
-	else
+	for (auto ItA = InA.Arrays.CreateConstIterator(), ItB = InB.Arrays.CreateConstIterator(); ItA; ++ItA, ++ItB)
 	{
-		InData.Recreate = false;
+		const TArray<FString> &DataA = ItA.Value().Data;
+		const TArray<FString> &DataB = ItB.Value().Data;
+		if (ItA.Key() != ItB.Key() || DataA.Num() != DataB.Num())
+			return false;
+
+		for (int32 i=0; i<DataA.Num(); i++)
+		{
+			if (!DataA.GetData()[i].Equals(DataB.GetData()[i], ESearchCase::CaseSensitive))
+				return false;
+		}
 	}
 
-	SaveCustomData_Internal(this, InObject, InData.Singles, InData.Arrays, InData.Maps);
+	for (auto ItA = InA.Maps.CreateConstIterator(), ItB = InB.Maps.CreateConstIterator(); ItA; ++ItA, ++ItB)
+	{
+		if (ItA.Key() != ItB.Key() || ItA.Value().Data.Num() != ItB.Value().Data.Num())
+			return false;
 
-	if (pInterface)
-    {
-		pInterface->Runtime_PostSave();
+		for (auto It2A = ItA.Value().Data.CreateConstIterator(), It2B = ItB.Value().Data.CreateConstIterator(); It2A; ++It2A, ++It2B)
+		{
+			if (!It2A.Key().Equals(It2B.Key(), ESearchCase::CaseSensitive) || !It2A.Value().Equals(It2B.Value(), ESearchCase::CaseSensitive))
+				return false;
+		}
 	}
 
-	return InData.GetCount() > 0;
+	return true;
 }
 
 //=================================================================
-// 
+// Records only keep who they are, values that appear more than
+// once are stored in the payload array once
 //=================================================================
-void USimpleSaveFile::SaveSimpleProperties(class UObject *InObject, FSimpleSaveData &InData, bool InIgnoreNativeProperties)
+void USimpleSaveFile::ShareIdenticalPayloads(const TArray<FCustomSaveData*> &InRecords, TArray<FSimpleSaveData> &OutPayloads, bool InGlobal)
 {
-	InData.Singles.Reset();
-	InData.Arrays.Reset();
-	InData.Maps.Reset();
+	OutPayloads.Reset();
 
-	SaveCustomData_Internal(NULL, InObject, InData.Singles, InData.Arrays, InData.Maps, true, NULL, InIgnoreNativeProperties);
+	//First record with the same values for each record
+	TArray<int32> FirstIdentical;
+	FirstIdentical.Init(INDEX_NONE, InRecords.Num());
+
+	TMultiMap<uint32, int32> Unique;
+	for (int32 i=0; i<InRecords.Num(); i++)
+	{
+		const FCustomSaveData &Data = *InRecords.GetData()[i];
+		if (Data.GetCount() == 0)
+			continue;
+
+		const uint32 iHash = HashRecordValues(Data);
+		for (auto It = Unique.CreateConstKeyIterator(iHash); It; ++It)
+		{
+			if (AreRecordValuesEqual(*InRecords.GetData()[It.Value()], Data))
+			{
+				FirstIdentical[i] = It.Value();
+				break;
+			}
+		}
+
+		if (FirstIdentical[i] == INDEX_NONE)
+		{
+			Unique.Add(iHash, i);
+		}
+	}
+
+	for (int32 i=0; i<InRecords.Num(); i++)
+	{
+		if (FirstIdentical[i] == INDEX_NONE)
+			continue;
+
+		FCustomSaveData &First = *InRecords.GetData()[FirstIdentical[i]];
+		if (First.PayloadIndex == INDEX_NONE)
+		{
+			FSimpleSaveData &Payload = OutPayloads.AddDefaulted_GetRef();
+			Payload.Singles = MoveTemp(First.Singles);
+			Payload.Arrays = MoveTemp(First.Arrays);
+			Payload.Maps = MoveTemp(First.Maps);
+
+			First.PayloadIndex = OutPayloads.Num() - 1;
+			First.PayloadIsGlobal = InGlobal;
+		}
+
+		FCustomSaveData &Data = *InRecords.GetData()[i];
+		Data.Singles.Empty();
+		Data.Arrays.Empty();
+		Data.Maps.Empty();
+		Data.PayloadIndex = First.PayloadIndex;
+		Data.PayloadIsGlobal = InGlobal;
+	}
 }
 
 //=================================================================
@@ -4099,8 +5445,13 @@ bool USimpleSaveFile::LoadGame(const class UObject *WorldContext, FString Filena
 		return false;
 	}
 
-	//
-	class USimpleSaveFile *pLoadGame = Cast<USimpleSaveFile>(UGameplayStatics::LoadGameFromSlot(Filename, 0));
+	//Read already if the menu prefetched it
+	class USimpleSaveFile *pLoadGame = pGameInstance->GetSavePrefetch()->TakeSaveFile(Filename);
+	if (!pLoadGame)
+	{
+		pLoadGame = Cast<USimpleSaveFile>(UGameplayStatics::LoadGameFromSlot(Filename, 0));
+	}
+
 	if (!pLoadGame)
 	{
 		UE_LOG(LogTemp, Error, TEXT("Failed to load game \"%s\""), *Filename);
@@ -4114,11 +5465,10 @@ bool USimpleSaveFile::LoadGame(const class UObject *WorldContext, FString Filena
 		return false;
 	}
 
-	//If no map name defined in the level then oh no
-	if (pLoadGame->CurrentMapName.IsNone())
+	//Same map, nothing needs to be reloaded
+	if (pGameInstance->UseInPlaceRestore() && pLoadGame->CanRestoreInPlace(WorldContext))
 	{
-		UE_LOG(LogTemp, Error, TEXT("Save game has no map name!"));
-		return false;
+		return RestoreSaveFile(WorldContext, pLoadGame, true);
 	}
 
 	//
@@ -4140,6 +5490,234 @@ bool USimpleSaveFile::LoadGame(const class UObject *WorldContext, FString Filena
 	return true;
 }
 
+//=================================================================
+// 
+//=================================================================
+class USimpleSaveFile *USimpleSaveFile::SaveForRestore(const class UObject *WorldContext)
+{
+	if (!IsValid(WorldContext))
+	{
+		UE_LOG(LogTemp, Fatal, TEXT("USimpleSaveFile::SaveForRestore: No world context!"));
+		return NULL;
+	}
+
+	if (!CanSave(WorldContext))
+	{
+		UE_LOG(LogTemp, Error, TEXT("USimpleSaveFile::CanSave returns false!"));
+		return NULL;
+	}
+
+	//
+	class USaveGameInstance *pGameInstance = Cast<USaveGameInstance>(UGameplayStatics::GetGameInstance(WorldContext));
+	if (!IsValid(pGameInstance))
+	{
+		UE_LOG(LogTemp, Fatal, TEXT("USimpleSaveFile::SaveForRestore: No game instance!"));
+		return NULL;
+	}
+
+	if (!IsValid(pGameInstance->GetLoadGame()))
+	{
+		pGameInstance->SetSaveGame(Cast<USimpleSaveFile>(UGameplayStatics::CreateSaveGameObject(USimpleSaveFile::StaticClass())));
+		if (!IsValid(pGameInstance->GetLoadGame()))
+		{
+			UE_LOG(LogTemp, Fatal, TEXT("USimpleSaveFile::SaveForRestore: Failed to create save game!"));
+			return NULL;
+		}
+	}
+
+	class USimpleSaveFile *pSaveGame = pGameInstance->GetLoadGame();
+
+	pSaveGame->KeepUnchangedRecords = true;
+	bool bSaved = pSaveGame->SaveData(WorldContext, true, pGameInstance->GetTotalTime(WorldContext), true);
+	pSaveGame->KeepUnchangedRecords = false;
+
+	return bSaved ? pSaveGame : NULL;
+}
+
+//=================================================================
+// 
+//=================================================================
+bool USimpleSaveFile::CaptureCheckpoint(const class UObject *WorldContext, FString FlushToSlot)
+{
+	class USimpleSaveFile *pSaveGame = SaveForRestore(WorldContext);
+	if (!pSaveGame)
+		return false;
+
+	class USaveGameInstance *pGameInstance = Cast<USaveGameInstance>(UGameplayStatics::GetGameInstance(WorldContext));
+
+	TArray<uint8> Data;
+	const bool bSerialized = UGameplayStatics::SaveGameToMemory(pSaveGame, Data);
+	pSaveGame->StartPackingLevels();
+
+	if (!bSerialized)
+	{
+		UE_LOG(LogTemp, Error, TEXT("USimpleSaveFile::CaptureCheckpoint: Failed to serialize save game!"));
+		return false;
+	}
+
+	//The bytes serialized for the checkpoint are written as they are on a worker, the header 
+	//and screenshot only once the save exists since the screenshot atlas drops slots without one
+	if (FlushToSlot.Len() > 0)
+	{
+		TSharedRef<TArray<uint8>> SlotData = MakeShared<TArray<uint8>>(Data);
+		TWeakObjectPtr<const class UObject> WeakContext(WorldContext);
+		TWeakObjectPtr<class USaveGameInstance> WeakInstance(pGameInstance);
+
+		pGameInstance->GetSavePrefetch()->BeginWrite(FlushToSlot);
+
+		Async(EAsyncExecution::ThreadPool, [SlotData, FlushToSlot, WeakContext, WeakInstance]()
+		{
+			const bool bSuccess = UGameplayStatics::SaveDataToSlot(*SlotData, FlushToSlot, 0);
+
+			AsyncTask(ENamedThreads::GameThread, [bSuccess, FlushToSlot, WeakContext, WeakInstance]()
+			{
+				if (WeakInstance.IsValid())
+				{
+					WeakInstance->GetSavePrefetch()->EndWrite(FlushToSlot);
+				}
+
+				if (!bSuccess)
+				{
+					UE_LOG(LogTemp, Error, TEXT("USimpleSaveFile::CaptureCheckpoint: Failed to write checkpoint to \"%s\"!"), *FlushToSlot);
+					return;
+				}
+
+				if (WeakContext.IsValid())
+				{
+					USimpleSaveHeader::SaveHeaderDataFor(WeakContext.Get(), FlushToSlot);
+				}
+
+				if (WeakInstance.IsValid())
+				{
+					WeakInstance->UpdateSaveFile(FlushToSlot);
+				}
+			});
+		});
+	}
+
+	pGameInstance->SetCheckpoint(MoveTemp(Data));
+
+	return true;
+}
+
+//=================================================================
+// 
+//=================================================================
+bool USimpleSaveFile::RestoreCheckpoint(const class UObject *WorldContext)
+{
+	if (!IsValid(WorldContext))
+	{
+		UE_LOG(LogTemp, Error, TEXT("No world context!"));
+		return false;
+	}
+
+	//
+	class USaveGameInstance *pGameInstance = Cast<USaveGameInstance>(UGameplayStatics::GetGameInstance(WorldContext));
+	if (!pGameInstance)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to get game instance!"));
+		return false;
+	}
+
+	if (!pGameInstance->HasCheckpoint())
+	{
+		UE_LOG(LogTemp, Error, TEXT("No checkpoint to restore!"));
+		return false;
+	}
+
+	if (pGameInstance->IsLoading())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Trying to restore checkpoint while loading!"));
+		return false;
+	}
+
+	class USimpleSaveFile *pLoadGame = Cast<USimpleSaveFile>(UGameplayStatics::LoadGameFromMemory(pGameInstance->GetCheckpoint()));
+	if (!pLoadGame || pLoadGame->CurrentMapName.IsNone())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to read checkpoint!"));
+		return false;
+	}
+
+	return RestoreSaveFile(WorldContext, pLoadGame, pGameInstance->UseInPlaceCheckpoints());
+}
+
+//=================================================================
+// 
+//=================================================================
+bool USimpleSaveFile::RestoreSaveFile(const class UObject *WorldContext, class USimpleSaveFile *pLoadGame, bool InAllowInPlace)
+{
+	class USaveGameInstance *pGameInstance = Cast<USaveGameInstance>(UGameplayStatics::GetGameInstance(WorldContext));
+	if (!pGameInstance || pGameInstance->IsLoading())
+	{
+		UE_LOG(LogTemp, Error, TEXT("USimpleSaveFile::RestoreSaveFile: Can't restore right now!"));
+		return false;
+	}
+
+	const bool bInPlace = InAllowInPlace && pLoadGame->CanRestoreInPlace(WorldContext);
+
+	//
+	pGameInstance->OnNewGame(const_cast<UObject*>(WorldContext), true);
+
+	//Mark us as loading the game
+	pGameInstance->StartLoading(pLoadGame, bInPlace);
+
+	if (bInPlace)
+	{
+		float fTimeSkip = 0.0f;
+		pGameInstance->HandleRestore(const_cast<UObject*>(WorldContext), false, fTimeSkip, false);
+		return true;
+	}
+
+	ISimpleSavingLoadingScreenModule& LoadingScreenModule = ISimpleSavingLoadingScreenModule::Get();
+	LoadingScreenModule.StartInGameLoadingScreen(true, 1.0f);
+
+	UGameplayStatics::OpenLevel(WorldContext, pLoadGame->CurrentMapName);
+	return true;
+}
+
+//=================================================================
+// Placed actors can't be brought back without loading the map, 
+// recreated ones are respawned either way
+//=================================================================
+bool USimpleSaveFile::CanRestoreInPlace(const class UObject *WorldContext)
+{
+	if (GetMapName(WorldContext) != CurrentMapName)
+		return false;
+
+	const FLevelSaveData *pLevelData = FindLevelData(CurrentMapName);
+	if (!pLevelData)
+		return true;
+
+	if (pLevelData->DeltaSaved)
+		return false;
+
+	TSet<FName> Names;
+	for (TActorIterator<AActor> It(WorldContext->GetWorld()); It; ++It)
+	{
+		if (!IsMarkedForDestruction(*It))
+		{
+			Names.Add(It->GetFName());
+		}
+	}
+
+	for (int32 i=0; i<pLevelData->Actors.Num(); i++)
+	{
+		const FCustomSaveData &Data = pLevelData->Actors.GetData()[i].Custom;
+
+		//Tagged actors are found by their tag
+		if (Data.Recreate || !Data.Tag.IsNone())
+			continue;
+
+		if (!Names.Contains(Data.Name))
+		{
+			UE_LOG(LogTemp, Display, TEXT("Checkpoint reopens the map, \"%s\" no longer exists"), *Data.Name.ToString());
+			return false;
+		}
+	}
+
+	return true;
+}
+
 //=================================================================
 // 
 //=================================================================
@@ -0,0 +1,358 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#include "Saving/SimpleSaveFileBenchmark.h"
+#include "Saving/SimpleSaveFile.h"
+#include "Saving/SaveGameInstance.h"
+#include "Kismet/GameplayStatics.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "EngineUtils.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSaveRestoreBenchmark, "SimpleSaving.Benchmark.SaveRestore", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+
+//=========================================================================================================================
+// 
+//=========================================================================================================================
+void FSaveBenchmarkSettings::ParseCommandLine(const TCHAR *InCommandLine)
+{
+	FParse::Value(InCommandLine, TEXT("SaveBenchPlaced="), PlacedActors);
+	FParse::Value(InCommandLine, TEXT("SaveBenchRecreated="), RecreatedActors);
+	FParse::Value(InCommandLine, TEXT("SaveBenchComponents="), ComponentsPerActor);
+	FParse::Value(InCommandLine, TEXT("SaveBenchObjects="), ObjectsPerActor);
+	FParse::Value(InCommandLine, TEXT("SaveBenchOuterDepth="), OuterDepth);
+	FParse::Value(InCommandLine, TEXT("SaveBenchAttached="), AttachedActors);
+	FParse::Value(InCommandLine, TEXT("SaveBenchArray="), ArraySize);
+	FParse::Value(InCommandLine, TEXT("SaveBenchMap="), MapSize);
+	FParse::Value(InCommandLine, TEXT("SaveBenchIterations="), Iterations);
+
+	Iterations = FMath::Max(Iterations, 1);
+}
+
+//=========================================================================================================================
+// 
+//=========================================================================================================================
+void USaveBenchmarkObject::Randomize(const FSaveBenchmarkSettings &InSettings)
+{
+	SomeInteger = FMath::RandRange(0, 1000);
+
+	SomeArray.SetNum(InSettings.ArraySize / 4);
+	for (int32 i=0; i<SomeArray.Num(); i++)
+	{
+		SomeArray.GetData()[i] = FMath::RandRange(0.0f, 100.0f);
+	}
+
+	if (Child)
+	{
+		Child->Randomize(InSettings);
+	}
+}
+
+//=========================================================================================================================
+// 
+//=========================================================================================================================
+void USaveBenchmarkComponent::Randomize(const FSaveBenchmarkSettings &InSettings)
+{
+	SomeInteger = FMath::RandRange(0, 1000);
+
+	SomeArray.SetNum(InSettings.ArraySize / 4);
+	for (int32 i=0; i<SomeArray.Num(); i++)
+	{
+		SomeArray.GetData()[i] = FMath::RandRange(0, 1000);
+	}
+}
+
+//=========================================================================================================================
+// 
+//=========================================================================================================================
+ASaveBenchmarkActor::ASaveBenchmarkActor()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+	RootComponent->SetMobility(EComponentMobility::Movable);
+}
+
+//=========================================================================================================================
+// 
+//=========================================================================================================================
+void ASaveBenchmarkActor::Randomize(const FSaveBenchmarkSettings &InSettings)
+{
+	SomeInteger = FMath::RandRange(0, 1000);
+
+	LargeArray.SetNum(InSettings.ArraySize);
+	for (int32 i=0; i<LargeArray.Num(); i++)
+	{
+		LargeArray.GetData()[i] = FMath::RandRange(0, 1000);
+	}
+
+	LargeMap.Reset();
+	for (int32 i=0; i<InSettings.MapSize; i++)
+	{
+		LargeMap.Emplace(i, FString::Printf(TEXT("Value_%d"), FMath::RandRange(0, 1000)));
+	}
+
+	for (int32 i=0; i<Objects.Num(); i++)
+	{
+		if (Objects.GetData()[i])
+		{
+			Objects.GetData()[i]->Randomize(InSettings);
+		}
+	}
+
+	TArray<class USaveBenchmarkComponent*> Components;
+	GetComponents(Components);
+	for (int32 i=0; i<Components.Num(); i++)
+	{
+		Components.GetData()[i]->Randomize(InSettings);
+	}
+
+	SetActorLocation(FVector(FMath::RandRange(-10000, 10000), FMath::RandRange(-10000, 10000), 0.0f));
+}
+
+//=========================================================================================================================
+// 
+//=========================================================================================================================
+static class ASaveBenchmarkActor *SpawnBenchmarkActor(UWorld *InWorld, const FSaveBenchmarkSettings &InSettings, bool InRecreate)
+{
+	class ASaveBenchmarkActor *pActor = InWorld->SpawnActor<ASaveBenchmarkActor>();
+	pActor->Recreate = InRecreate;
+
+	for (int32 i=0; i<InSettings.ComponentsPerActor; i++)
+	{
+		class USaveBenchmarkComponent *pComponent = NewObject<USaveBenchmarkComponent>(pActor, *FString::Printf(TEXT("Component_%d"), i));
+		pComponent->SetupAttachment(pActor->GetRootComponent());
+		pComponent->RegisterComponent();
+	}
+
+	for (int32 i=0; i<InSettings.ObjectsPerActor; i++)
+	{
+		class USaveBenchmarkObject *pObject = NewObject<USaveBenchmarkObject>(pActor);
+		pActor->Objects.Add(pObject);
+
+		for (int32 j=0; j<InSettings.OuterDepth; j++)
+		{
+			pObject->Child = NewObject<USaveBenchmarkObject>(pObject);
+			pObject = pObject->Child;
+		}
+	}
+
+	return pActor;
+}
+
+//=========================================================================================================================
+// 
+//=========================================================================================================================
+static void RandomizeBenchmarkWorld(UWorld *InWorld, const FSaveBenchmarkSettings &InSettings)
+{
+	for (TActorIterator<ASaveBenchmarkActor> It(InWorld); It; ++It)
+	{
+		It->Randomize(InSettings);
+	}
+}
+
+//=========================================================================================================================
+// 
+//=========================================================================================================================
+enum ESaveBenchmarkMetric
+{
+	Metric_SaveData,
+	Metric_Serialize,
+	Metric_WriteToDisk,
+	Metric_LoadGameFromSlot,
+	Metric_BasicObjects,
+	Metric_ClearObjects,
+	Metric_RecreateAllObjects,
+	Metric_RestoreActors,
+	Metric_RestoreDynamicObjects,
+	Metric_CalculateLevelChangeActor,
+	Metric_CallOnRestore,
+	Metric_Finish,
+	Metric_Count
+};
+
+static const TCHAR *MetricNames[Metric_Count] =
+{
+	TEXT("SaveData"),
+	TEXT("Serialize"),
+	TEXT("WriteToDisk"),
+	TEXT("LoadGameFromSlot"),
+	TEXT("HandleRestore_BasicObjects"),
+	TEXT("HandleRestore_ClearObjects"),
+	TEXT("HandleRestore_RecreateAllObjects"),
+	TEXT("HandleRestore_RestoreActors"),
+	TEXT("HandleRestore_RestoreDynamicObjects"),
+	TEXT("HandleRestore_CalculateLevelChangeActor"),
+	TEXT("HandleRestore_CallOnRestore"),
+	TEXT("HandleRestore_Finish"),
+};
+
+//=========================================================================================================================
+// Nearest rank of the sorted samples
+//=========================================================================================================================
+FORCEINLINE static double GetPercentile(const TArray<double> &InSorted, double InPercentile)
+{
+	if (InSorted.Num() == 0)
+		return 0.0;
+
+	const int32 iRank = FMath::Clamp(FMath::CeilToInt(InPercentile * InSorted.Num()) - 1, 0, InSorted.Num() - 1);
+	return InSorted.GetData()[iRank];
+}
+
+//=========================================================================================================================
+// 
+//=========================================================================================================================
+bool FSaveRestoreBenchmark::RunTest(const FString& Parameters)
+{
+	FSaveBenchmarkSettings Settings;
+	Settings.ParseCommandLine(FCommandLine::Get());
+	Settings.ParseCommandLine(*Parameters);
+
+	//Game world of its own with the pointers HandleRestore requires
+	class USaveGameInstance *pGameInstance = NewObject<USaveGameInstance>(GEngine);
+	pGameInstance->InitializeStandalone();
+
+	UWorld *pWorld = pGameInstance->GetWorld();
+	if (!pWorld)
+	{
+		AddError(TEXT("Failed to create a world!"));
+		return false;
+	}
+
+	class AGameStateBase *pGameState = pWorld->SpawnActor<AGameStateBase>();
+	pWorld->SetGameState(pGameState);
+
+	class APlayerController *pController = pWorld->SpawnActor<APlayerController>();
+	class APawn *pPawn = pWorld->SpawnActor<APawn>();
+	pController->Possess(pPawn);
+
+	TArray<class ASaveBenchmarkActor*> Placed;
+	for (int32 i=0; i<Settings.PlacedActors; i++)
+	{
+		Placed.Add(SpawnBenchmarkActor(pWorld, Settings, false));
+	}
+
+	for (int32 i=0; i<Settings.RecreatedActors; i++)
+	{
+		SpawnBenchmarkActor(pWorld, Settings, true);
+	}
+
+	for (int32 i=0; i<Settings.AttachedActors && Placed.Num() > 0; i++)
+	{
+		class ASaveBenchmarkActor *pActor = SpawnBenchmarkActor(pWorld, Settings, false);
+		pActor->AttachToActor(Placed.GetData()[i % Placed.Num()], FAttachmentTransformRules::KeepRelativeTransform);
+	}
+
+	const FString Slot = TEXT("SaveRestoreBenchmark");
+
+	TArray<double> Samples[Metric_Count];
+	int64 FileSize = 0;
+	const uint64 BaselineUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+	uint64 PeakUsedPhysical = BaselineUsedPhysical;
+	bool bSuccess = true;
+
+	//Times one phase and keeps track of the highest memory use after it
+	auto Measure = [&Samples, &PeakUsedPhysical](int32 InMetric, TFunctionRef<bool()> InFunction)
+	{
+		const double flStart = FPlatformTime::Seconds();
+		const bool bResult = InFunction();
+		Samples[InMetric].Add((FPlatformTime::Seconds() - flStart) * 1000.0);
+		PeakUsedPhysical = FMath::Max(PeakUsedPhysical, (uint64)FPlatformMemory::GetStats().UsedPhysical);
+		return bResult;
+	};
+
+	for (int32 iIteration=0; iIteration<Settings.Iterations && bSuccess; iIteration++)
+	{
+		RandomizeBenchmarkWorld(pWorld, Settings);
+
+		class USimpleSaveFile *pSaveFile = Cast<USimpleSaveFile>(UGameplayStatics::CreateSaveGameObject(USimpleSaveFile::StaticClass()));
+		TArray<uint8> FileData;
+
+		bSuccess &= Measure(Metric_SaveData, [&]() { return pSaveFile->SaveData(pWorld, false, 0.0f); });
+		bSuccess &= Measure(Metric_Serialize, [&]() { return UGameplayStatics::SaveGameToMemory(pSaveFile, FileData); });
+		bSuccess &= Measure(Metric_WriteToDisk, [&]() { return UGameplayStatics::SaveDataToSlot(FileData, Slot, 0); });
+		FileSize = FileData.Num();
+
+		//Restoring has something to change
+		RandomizeBenchmarkWorld(pWorld, Settings);
+
+		class USimpleSaveFile *pLoadGame = NULL;
+		bSuccess &= Measure(Metric_LoadGameFromSlot, [&]()
+		{
+			pLoadGame = Cast<USimpleSaveFile>(UGameplayStatics::LoadGameFromSlot(Slot, 0));
+			return pLoadGame != NULL;
+		});
+
+		if (!bSuccess)
+			break;
+
+		pGameInstance->StartLoading(pLoadGame);
+
+		float fTimeSkip = 0.0f;
+		TMap<FName, class AActor*> CustomTags;
+		int32 Start = 0;
+
+		bSuccess &= Measure(Metric_BasicObjects, [&]() { return pLoadGame->HandleRestore_BasicObjects(pWorld, fTimeSkip, CustomTags); });
+		bSuccess &= Measure(Metric_ClearObjects, [&]() { return pLoadGame->HandleRestore_ClearObjects(pWorld); });
+		bSuccess &= Measure(Metric_RecreateAllObjects, [&]() { return pLoadGame->HandleRestore_RecreateAllObjects(pWorld, CustomTags); });
+		bSuccess &= Measure(Metric_RestoreActors, [&]() { Start = 0; return pLoadGame->HandleRestore_RestoreActors(pWorld, Start, 0); });
+		bSuccess &= Measure(Metric_RestoreDynamicObjects, [&]() { Start = 0; return pLoadGame->HandleRestore_RestoreDynamicObjects(pWorld, Start, 0); });
+		bSuccess &= Measure(Metric_CalculateLevelChangeActor, [&]() { return pLoadGame->HandleRestore_CalculateLevelChangeActor(pWorld); });
+		bSuccess &= Measure(Metric_CallOnRestore, [&]() { return pLoadGame->HandleRestore_CallOnRestore(pWorld); });
+		bSuccess &= Measure(Metric_Finish, [&]() { return pLoadGame->HandleRestore_Finish(pWorld, false); });
+
+		pGameInstance->FinishLoading(pWorld);
+	}
+
+	UGameplayStatics::DeleteGameInSlot(Slot, 0);
+	pWorld->DestroyWorld(false);
+	GEngine->DestroyWorldContext(pWorld);
+	pGameInstance->Shutdown();
+
+	//Same numbers as CSV for spreadsheets and as JSON for CI
+	FString Csv = TEXT("Metric,P50Ms,P95Ms,MinMs,MaxMs\n");
+	FString Json = FString::Printf(TEXT("{\n\t\"placedActors\": %d,\n\t\"recreatedActors\": %d,\n\t\"componentsPerActor\": %d,\n\t\"objectsPerActor\": %d,\n\t\"outerDepth\": %d,\n\t\"attachedActors\": %d,\n\t\"arraySize\": %d,\n\t\"mapSize\": %d,\n\t\"iterations\": %d,\n\t\"fileSizeBytes\": %lld,\n\t\"peakUsedPhysicalBytes\": %llu,\n\t\"peakGrowthBytes\": %llu,\n\t\"metrics\": {\n"),
+		Settings.PlacedActors, Settings.RecreatedActors, Settings.ComponentsPerActor, Settings.ObjectsPerActor, Settings.OuterDepth,
+		Settings.AttachedActors, Settings.ArraySize, Settings.MapSize, Settings.Iterations, FileSize, PeakUsedPhysical, PeakUsedPhysical - BaselineUsedPhysical);
+
+	for (int32 i=0; i<Metric_Count; i++)
+	{
+		Samples[i].Sort();
+
+		const double flP50 = GetPercentile(Samples[i], 0.5);
+		const double flP95 = GetPercentile(Samples[i], 0.95);
+		const double flMin = Samples[i].Num() > 0 ? Samples[i].GetData()[0] : 0.0;
+		const double flMax = Samples[i].Num() > 0 ? Samples[i].Last() : 0.0;
+
+		Csv += FString::Printf(TEXT("%s,%.3f,%.3f,%.3f,%.3f\n"), MetricNames[i], flP50, flP95, flMin, flMax);
+		Json += FString::Printf(TEXT("\t\t\"%s\": { \"p50Ms\": %.3f, \"p95Ms\": %.3f, \"minMs\": %.3f, \"maxMs\": %.3f }%s\n"), MetricNames[i], flP50, flP95, flMin, flMax, i + 1 < Metric_Count ? TEXT(",") : TEXT(""));
+
+		UE_LOG(LogTemp, Display, TEXT("%s: p50 %.3f ms, p95 %.3f ms"), MetricNames[i], flP50, flP95);
+	}
+
+	Csv += FString::Printf(TEXT("FileSizeBytes,%lld,,,\n"), FileSize);
+	Csv += FString::Printf(TEXT("PeakUsedPhysicalBytes,%llu,,,\n"), PeakUsedPhysical);
+	Csv += FString::Printf(TEXT("PeakGrowthBytes,%llu,,,\n"), PeakUsedPhysical - BaselineUsedPhysical);
+	Json += TEXT("\t}\n}\n");
+
+	UE_LOG(LogTemp, Display, TEXT("Save file %lld bytes, peak memory %.1f MB, %.1f MB over the start"), FileSize, PeakUsedPhysical / (1024.0 * 1024.0), (PeakUsedPhysical - BaselineUsedPhysical) / (1024.0 * 1024.0));
+
+	const FString OutputFolder = FPaths::ProjectSavedDir() + TEXT("Benchmarks/");
+	FFileHelper::SaveStringToFile(Csv, *(OutputFolder + TEXT("SaveRestore.csv")));
+	FFileHelper::SaveStringToFile(Json, *(OutputFolder + TEXT("SaveRestore.json")));
+
+	if (!bSuccess)
+	{
+		AddError(TEXT("Save or restore failed!"));
+	}
+
+	return bSuccess;
+}
@@ -0,0 +1,103 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Components/SceneComponent.h"
+#include "Saving/SaveInterface.h"
+#include "SimpleSaveFileBenchmark.generated.h"
+
+//=================================================================
+// Counts of the synthetic world, each can be overridden on the
+// command line, for example -SaveBenchPlaced=2000
+//=================================================================
+struct FSaveBenchmarkSettings
+{
+	int32 PlacedActors = 500;
+	int32 RecreatedActors = 200;
+	int32 ComponentsPerActor = 2;
+	int32 ObjectsPerActor = 1;
+	int32 OuterDepth = 2;
+	int32 AttachedActors = 50;
+	int32 ArraySize = 256;
+	int32 MapSize = 64;
+	int32 Iterations = 10;
+
+	void ParseCommandLine(const TCHAR *InCommandLine);
+};
+
+//=================================================================
+// Dynamic object saved through an actor, Child makes the outer chain
+//=================================================================
+UCLASS()
+class USaveBenchmarkObject : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	void Randomize(const FSaveBenchmarkSettings &InSettings);
+
+	UPROPERTY(SaveGame)
+	int32 SomeInteger = 0;
+
+	UPROPERTY(SaveGame)
+	TArray<float> SomeArray;
+
+	UPROPERTY(SaveGame)
+	class USaveBenchmarkObject *Child = NULL;
+};
+
+//=================================================================
+// 
+//=================================================================
+UCLASS()
+class USaveBenchmarkComponent : public USceneComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	void Randomize(const FSaveBenchmarkSettings &InSettings);
+
+	UPROPERTY(SaveGame)
+	int32 SomeInteger = 0;
+
+	UPROPERTY(SaveGame)
+	TArray<int32> SomeArray;
+};
+
+//=================================================================
+// Placed or recreated actor of the synthetic world
+//=================================================================
+UCLASS()
+class ASaveBenchmarkActor : public AActor, public ISaveInterface
+{
+	GENERATED_BODY()
+
+public:
+
+	ASaveBenchmarkActor();
+
+	virtual bool ShouldDeleteOnRestore() const override { return Recreate; }
+
+	void Randomize(const FSaveBenchmarkSettings &InSettings);
+
+	UPROPERTY(SaveGame)
+	bool Recreate = false;
+
+	UPROPERTY(SaveGame)
+	int32 SomeInteger = 0;
+
+	UPROPERTY(SaveGame)
+	TArray<int32> LargeArray;
+
+	UPROPERTY(SaveGame)
+	TMap<int32, FString> LargeMap;
+
+	UPROPERTY(SaveGame)
+	TArray<class USaveBenchmarkObject*> Objects;
+};
@@ -3,6 +3,7 @@
 #include "AutomationTest.h"
 
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimplePropertiesTest, "SimpleSaving.SimpleProperties", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStructParsingBenchmark, "SimpleSaving.Benchmark.StructParsing", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
 
 
 //=========================================================================================================================
@@ -98,4 +99,118 @@ bool FSimplePropertiesTest::RunTest(const FString& Parameters)
 
 	// Make the test pass by returning true, or fail by returning false.
 	return pTestObject1->Matches(pTestObject2);
+}
+
+//=========================================================================================================================
+// 
+//=========================================================================================================================
+void USaveTestInventory::Randomize(int32 InCount)
+{
+	Items.SetNum(InCount);
+	for (int32 i=0; i<Items.Num(); i++)
+	{
+		FSaveTestInventoryItem &Item = Items.GetData()[i];
+		Item.ItemId = *FString::Printf(TEXT("Item_%d"), FMath::RandRange(0, 100));
+		Item.Description = FString::Printf(TEXT("Slightly used item number %d"), i);
+		Item.Count = FMath::RandRange(1, 99);
+		Item.Durability = FMath::RandRange(0.0f, 1.0f);
+		Item.Offset = FVector(FMath::RandRange(-100, 100), FMath::RandRange(-100, 100), FMath::RandRange(-100, 100));
+
+		Item.Modifiers.SetNum(FMath::RandRange(0, 8));
+		for (int32 j=0; j<Item.Modifiers.Num(); j++)
+		{
+			Item.Modifiers.GetData()[j] = FMath::RandRange(0, 1000);
+		}
+	}
+}
+
+//=========================================================================================================================
+// 
+//=========================================================================================================================
+bool USaveTestInventory::Matches(class USaveTestInventory* InOther) const
+{
+	if (Items.Num() != InOther->Items.Num())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Inventory does not match: Sizes %d and %d!"), Items.Num(), InOther->Items.Num());
+		return false;
+	}
+
+	for (int32 i=0; i<Items.Num(); i++)
+	{
+		const FSaveTestInventoryItem &A = Items.GetData()[i];
+		const FSaveTestInventoryItem &B = InOther->Items.GetData()[i];
+
+		if (A.ItemId != B.ItemId || A.Description != B.Description || A.Count != B.Count || A.Modifiers != B.Modifiers ||
+			FMath::Abs(A.Durability - B.Durability) > KINDA_SMALL_NUMBER || !A.Offset.Equals(B.Offset))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Inventory does not match: Index %d"), i);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//=========================================================================================================================
+// Writes the items in the same "(Key=Value,...)" form the save file uses for structs
+//=========================================================================================================================
+static void ExportInventoryItems(class USaveTestInventory *InObject, FArrayData &OutData)
+{
+	const UScriptStruct *pStruct = FSaveTestInventoryItem::StaticStruct();
+
+	OutData.Data.Reset(InObject->Items.Num());
+	for (int32 i=0; i<InObject->Items.Num(); i++)
+	{
+		FString Value = TEXT("(");
+		int32 nCount = 0;
+		for (TFieldIterator<FProperty> Property(pStruct); Property; ++Property)
+		{
+			if (nCount++ > 0)
+			{
+				Value += TEXT(",");
+			}
+
+			void *ValuePtr = Property->ContainerPtrToValuePtr<void>(&InObject->Items.GetData()[i]);
+			Value += Property->GetName() + TEXT("=");
+			Property->ExportTextItem_Direct(Value, ValuePtr, NULL, InObject, PPF_SimpleObjectText);
+		}
+
+		Value += TEXT(")");
+		OutData.Data.Add(Value);
+	}
+}
+
+//=========================================================================================================================
+// 
+//=========================================================================================================================
+bool FStructParsingBenchmark::RunTest(const FString& Parameters)
+{
+	const int32 iItems = 5000;
+	const int32 iIterations = 20;
+
+	class USaveTestInventory *pSource = NewObject<USaveTestInventory>();
+	pSource->Randomize(iItems);
+
+	FSimpleSaveData Data;
+	ExportInventoryItems(pSource, Data.Arrays.Emplace(GET_MEMBER_NAME_CHECKED(USaveTestInventory, Items)));
+
+	class USaveTestInventory *pTarget = NewObject<USaveTestInventory>();
+
+	double flBest = TNumericLimits<double>::Max();
+	double flTotal = 0.0;
+	for (int32 i=0; i<iIterations; i++)
+	{
+		pTarget->Items.Reset();
+
+		double flStart = FPlatformTime::Seconds();
+		USimpleSaveFile::LoadSimpleProperties(pTarget, Data);
+		double flTime = FPlatformTime::Seconds() - flStart;
+
+		flBest = FMath::Min(flBest, flTime);
+		flTotal += flTime;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Struct parsing: %d items, best %.3f ms, average %.3f ms"), iItems, flBest * 1000.0, flTotal * 1000.0 / iIterations);
+
+	return pSource->Matches(pTarget);
 }
\ No newline at end of file
@@ -33,29 +33,31 @@ bool DoPropertiesMatch(const FString &Old, const FString &New)
 //=================================================================
 // 
 //=================================================================
-bool CompareSingles(const FCustomSaveData &My, const FCustomSaveData &Other)
+bool CompareSingles(const FCustomSaveData &My, const TArray<FSimpleSaveData> &MyPayloads, const FCustomSaveData &Other, const TArray<FSimpleSaveData> &OtherPayloads)
 {
+	const TMap<FName, FString> &MySingles = My.GetSingles(MyPayloads);
+
 	//
-	for (auto It = Other.Singles.CreateConstIterator(); It; ++It)
+	for (auto It = Other.GetSingles(OtherPayloads).CreateConstIterator(); It; ++It)
 	{
 		//
-		if (!My.Singles.Contains(It.Key()))
+		if (!MySingles.Contains(It.Key()))
 		{
 			UE_LOG(LogTemp, Fatal, TEXT("Property \"%s\" not found in new object with tag \"%s\" name \"%s\" class \"%s\"!"),
 				*It.Key().ToString(),
-				*Other.Tag.ToString(),
+				*Other.GetTagString(),
 				*Other.Name.ToString(),
 				*Other.Class->GetName());
 
 			return false;
 		}
 
-		const FString &String = My.Singles[It.Key()];
+		const FString &String = MySingles[It.Key()];
 		if (DoPropertiesMatch(It.Value(), String) == false)
 		{
 			UE_LOG(LogTemp, Fatal, TEXT("Property \"%s\" value mismatch found in new object with tag \"%s\" name \"%s\" class \"%s\"! Current value \"%s\" old value \"%s\"!"),
 				*It.Key().ToString(),
-				*Other.Tag.ToString(),
+				*Other.GetTagString(),
 				*Other.Name.ToString(),
 				*Other.Class->GetName(),
 				*String, 
@@ -80,7 +82,7 @@ bool CompareArrays(const FCustomSaveData &My, const FCustomSaveData &Other)
 		{
 			UE_LOG(LogTemp, Fatal, TEXT("Array Property \"%s\" not found in new object with tag \"%s\" name \"%s\" class \"%s\"!"),
 				*It.Key().ToString(),
-				*Other.Tag.ToString(),
+				*Other.GetTagString(),
 				*Other.Name.ToString(),
 				*Other.Class->GetName());
 
@@ -93,7 +95,7 @@ bool CompareArrays(const FCustomSaveData &My, const FCustomSaveData &Other)
 		{
 			UE_LOG(LogTemp, Fatal, TEXT("Array Property \"%s\" size mismatch found in new object with tag \"%s\" name \"%s\" class \"%s\"! Current size %d old size %d!"),
 				*It.Key().ToString(),
-				*Other.Tag.ToString(),
+				*Other.GetTagString(),
 				*Other.Name.ToString(),
 				*Other.Class->GetName(),
 				Array.Data.Num(),
@@ -107,7 +109,7 @@ bool CompareArrays(const FCustomSaveData &My, const FCustomSaveData &Other)
 			{
 				UE_LOG(LogTemp, Fatal, TEXT("Array Property \"%s\" value mismatch found in new object with tag \"%s\" name \"%s\" class \"%s\"! Index %d Current value \"%s\" old value \"%s\"!"),
 					*It.Key().ToString(),
-					*Other.Tag.ToString(),
+					*Other.GetTagString(),
 					*Other.Name.ToString(),
 					*Other.Class->GetName(),
 					i,
@@ -134,7 +136,7 @@ bool CompareMaps(const FCustomSaveData &My, const FCustomSaveData &Other)
 		{
 			UE_LOG(LogTemp, Fatal, TEXT("Map Property \"%s\" not found in new object with tag \"%s\" name \"%s\" class \"%s\"!"),
 				*It.Key().ToString(),
-				*Other.Tag.ToString(),
+				*Other.GetTagString(),
 				*Other.Name.ToString(),
 				*Other.Class->GetName());
 
@@ -147,7 +149,7 @@ bool CompareMaps(const FCustomSaveData &My, const FCustomSaveData &Other)
 		{
 			UE_LOG(LogTemp, Fatal, TEXT("Map Property \"%s\" size mismatch found in new object with tag \"%s\" name \"%s\" class \"%s\"! Current size %d old size %d!"),
 				*It.Key().ToString(),
-				*Other.Tag.ToString(),
+				*Other.GetTagString(),
 				*Other.Name.ToString(),
 				*Other.Class->GetName(),
 				Map.Data.Num(),
@@ -162,7 +164,7 @@ bool CompareMaps(const FCustomSaveData &My, const FCustomSaveData &Other)
 			{
 				UE_LOG(LogTemp, Fatal, TEXT("Map Property \"%s\" value mismatch found in new object with tag \"%s\" name \"%s\" class \"%s\"! Value \"%s\" not found in new!"),
 					*It.Key().ToString(),
-					*Other.Tag.ToString(),
+					*Other.GetTagString(),
 					*Other.Name.ToString(),
 					*Other.Class->GetName(),
 					*It2.Key())
@@ -173,7 +175,7 @@ bool CompareMaps(const FCustomSaveData &My, const FCustomSaveData &Other)
 			{
 				UE_LOG(LogTemp, Fatal, TEXT("Map Property \"%s\" value mismatch found in new object with tag \"%s\" name \"%s\" class \"%s\"! Key \"%s\" Current value \"%s\" old value \"%s\"!"),
 					*It.Key().ToString(),
-					*Other.Tag.ToString(),
+					*Other.GetTagString(),
 					*Other.Name.ToString(),
 					*Other.Class->GetName(),
 					*It2.Key(),
@@ -190,9 +192,9 @@ bool CompareMaps(const FCustomSaveData &My, const FCustomSaveData &Other)
 //=================================================================
 // 
 //=================================================================
-bool CompareCustomSaveData(const FCustomSaveData &My, const FCustomSaveData &Other)
+bool CompareCustomSaveData(const FCustomSaveData &My, const TArray<FSimpleSaveData> &MyPayloads, const FCustomSaveData &Other, const TArray<FSimpleSaveData> &OtherPayloads)
 {
-	if (CompareSingles(My, Other) == false)
+	if (CompareSingles(My, MyPayloads, Other, OtherPayloads) == false)
 		return false;
 
 	return true;
@@ -216,7 +218,7 @@ FORCEINLINE int32 GetMyObjectIndex(const FCustomSaveData &Other, const TArray<cl
 //=================================================================
 // 
 //=================================================================
-bool CompareArrayCustomSaveData(const TArray<FCustomSaveData> &InMy, const TArray<FCustomSaveData> &InOther, const TArray<class UObject*> &InMyObjects, const TArray<class UObject*> &InOtherObjects)
+bool CompareArrayCustomSaveData(const TArray<FCustomSaveData> &InMy, const TArray<FCustomSaveData> &InOther, const TArray<class UObject*> &InMyObjects, const TArray<class UObject*> &InOtherObjects, const TArray<FSimpleSaveData> &InMyPayloads, const TArray<FSimpleSaveData> &InOtherPayloads)
 {
 	for (int32 i=0; i<InOther.Num(); i++)
 	{
@@ -226,7 +228,7 @@ bool CompareArrayCustomSaveData(const TArray<FCustomSaveData> &InMy, const TArra
 		if (iMyData == INDEX_NONE)
 		{
 			UE_LOG(LogTemp, Fatal, TEXT("Failed to find object with tag \"%s\" name \"%s\" class \"%s\" in current object list!"),
-					*Other.Tag.ToString(),
+					*Other.GetTagString(),
 					*Other.Name.ToString(),
 					*Other.Class->GetName());
 			return false;
@@ -235,7 +237,7 @@ bool CompareArrayCustomSaveData(const TArray<FCustomSaveData> &InMy, const TArra
 		const FCustomSaveData &My = InMy.GetData()[iMyData];
 
 		//Compare the actual data
-		if (!CompareCustomSaveData(My, Other))
+		if (!CompareCustomSaveData(My, InMyPayloads, Other, InOtherPayloads))
 		{
 			return false;
 		}
@@ -260,7 +262,7 @@ FORCEINLINE class UObject *GetObjectFromArray(const FCustomSaveData &InData, con
 //=================================================================
 // 
 //=================================================================
-bool CompareActorSaveData(const TArray<FActorSaveData> &InMyActors, const TArray<FActorSaveData> &InOtherActors, const TArray<class UObject*> &InMyObjects, const TArray<class UObject*> &InOtherObjects)
+bool CompareActorSaveData(const TArray<FActorSaveData> &InMyActors, const TArray<FActorSaveData> &InOtherActors, const TArray<class UObject*> &InMyObjects, const TArray<class UObject*> &InOtherObjects, const TArray<FSimpleSaveData> &InMyPayloads, const TArray<FSimpleSaveData> &InOtherPayloads)
 {
 	//Go through other actors
 	for (int32 i=0; i<InOtherActors.Num(); i++)
@@ -271,7 +273,7 @@ bool CompareActorSaveData(const TArray<FActorSaveData> &InMyActors, const TArray
 		if (iMyData == INDEX_NONE)
 		{
 			UE_LOG(LogTemp, Fatal, TEXT("Failed to find actor with tag \"%s\" name \"%s\" class \"%s\" in current object list! Old object \"%s\" [%d/%d]. My index [%d/%d]. My data list size: %d."),
-					*Other.Custom.Tag.ToString(),
+					*Other.Custom.GetTagString(),
 					*Other.Custom.Name.ToString(),
 					*Other.Custom.Class->GetName(),
 					InOtherObjects.IsValidIndex(Other.Custom.ObjectIndex) && IsValid(InOtherObjects.GetData()[Other.Custom.ObjectIndex]) ? *InOtherObjects.GetData()[Other.Custom.ObjectIndex]->GetName() : TEXT("NULL"),
@@ -284,7 +286,7 @@ bool CompareActorSaveData(const TArray<FActorSaveData> &InMyActors, const TArray
 		const FActorSaveData &My = InMyActors.GetData()[iMyData];
 
 		//Compare the actual data
-		if (!CompareCustomSaveData(My.Custom, Other.Custom))
+		if (!CompareCustomSaveData(My.Custom, InMyPayloads, Other.Custom, InOtherPayloads))
 		{
 			return false;
 		}
@@ -318,37 +320,38 @@ bool USimpleSaveFile::DebugSaveGame(const class UObject *WorldContext, bool InMu
 	FName MapName = *UGameplayStatics::GetCurrentLevelName(WorldContext);
 
 	//Compare global actors data
-	if (!CompareActorSaveData(GetGlobalActors(), pCompareTo->GetGlobalActors(), GetGlobalSaveObjects(), pCompareTo->GetGlobalSaveObjects()))
+	if (!CompareActorSaveData(GetGlobalActors(), pCompareTo->GetGlobalActors(), GetGlobalSaveObjects(), pCompareTo->GetGlobalSaveObjects(), SharedPayloads, pCompareTo->SharedPayloads))
 	{
 		return false;
 	}
 
 	//Compare global custom objects
-	if (!CompareArrayCustomSaveData(GetCustomObjects(), pCompareTo->GetCustomObjects(), GetGlobalSaveObjects(), pCompareTo->GetGlobalSaveObjects()))
+	if (!CompareArrayCustomSaveData(GetCustomObjects(), pCompareTo->GetCustomObjects(), GetGlobalSaveObjects(), pCompareTo->GetGlobalSaveObjects(), SharedPayloads, pCompareTo->SharedPayloads))
 	{
 		return false;
 	}
 
-	const FLevelSaveData *pMyLevelData = GetLevelSaveData(MapName);
+	//The load game keeps the level packed until it is restored
+	const FLevelSaveData *pMyLevelData = FindLevelData(MapName);
 	if (pMyLevelData == NULL)
 	{
 		UE_LOG(LogTemp, Fatal, TEXT("No current level data!"));
 	}
 
-	const FLevelSaveData *pOtherLevelData = pCompareTo->GetLevelSaveData(MapName);
+	const FLevelSaveData *pOtherLevelData = pCompareTo->FindLevelData(MapName);
 	if (pOtherLevelData == NULL)
 	{
 		UE_LOG(LogTemp, Fatal, TEXT("No old level data!"));
 	}
 
 	//Compare level actor data
-	if (!CompareActorSaveData(pMyLevelData->Actors, pOtherLevelData->Actors, GetLocalSaveObjects(), pCompareTo->GetLocalSaveObjects()))
+	if (!CompareActorSaveData(pMyLevelData->Actors, pOtherLevelData->Actors, GetLocalSaveObjects(), pCompareTo->GetLocalSaveObjects(), pMyLevelData->SharedPayloads, pOtherLevelData->SharedPayloads))
 	{
 		return false;
 	}
 
 	//Compare level custom objects data
-	if (!CompareArrayCustomSaveData(pMyLevelData->CustomObjects, pOtherLevelData->CustomObjects, GetLocalSaveObjects(), pCompareTo->GetLocalSaveObjects()))
+	if (!CompareArrayCustomSaveData(pMyLevelData->CustomObjects, pOtherLevelData->CustomObjects, GetLocalSaveObjects(), pCompareTo->GetLocalSaveObjects(), pMyLevelData->SharedPayloads, pOtherLevelData->SharedPayloads))
 	{
 		return false;
 	}
@@ -11,6 +11,8 @@
 #include "HAL/FileManager.h"
 #include "Engine/Texture2D.h"
 #include "Misc/FileHelper.h"
+#include "Async/Async.h"
+#include "Saving/ScreenshotAtlas.h"
 
 //=================================================================
 // 
@@ -74,7 +76,7 @@ bool USimpleSaveHeader::SaveHeaderDataFor(const class UObject* WorldContext, con
 
 		if (bRequestScreenshot)
 		{
-			pHeader->Screenshot(Filename);
+			pHeader->Screenshot(Filename, pGameInstance->ScreenshotHeight, pGameInstance->ScreenshotQuality);
 		}
 		return true;
 	}
@@ -191,128 +193,212 @@ class USimpleSaveHeader* USimpleSaveHeader::GetHeaderData(const class UObject* W
 //=================================================================
 // 
 //=================================================================
-void USimpleSaveHeader::Screenshot(const FString &Filename)
+void USimpleSaveHeader::Screenshot(const FString &Filename, int32 InHeight, int32 InQuality)
 {
 	if (FilesRequestingScreenshot.Num() == 0)
 	{
 		GEngine->GameViewport->OnScreenshotCaptured().AddUObject(this, &USimpleSaveHeader::AcceptScreenshot);
 	}
 
+	ScreenshotHeight = FMath::Max(InHeight, 1);
+	ScreenshotQuality = FMath::Clamp(InQuality, 1, 100);
+
 	FilesRequestingScreenshot.AddUnique(Filename);
 	FScreenshotRequest::RequestScreenshot(false); // False means don't include any UI
 }
 
 //=================================================================
-// 
+// Box filter over whole source pixels. Source rows are first added
+// up in one straight run, then each target pixel sums its own run
+// of columns, so there are no scattered writes in either loop
 //=================================================================
-static FColor GetTotalColor(int32 InSizeX, int32 InSizeY, const TArray<FColor>& InImageData, int32 x, int32 y, float offset, int32 count)
+void USimpleSaveHeader::DownscaleScreenshot(int32 InSizeX, int32 InSizeY, const TArray<FColor> &InImageData, int32 InTargetX, int32 InTargetY, TArray<FColor> &OutData)
 {
-	FLinearColor TotalColor = FLinearColor::Black;
+	OutData.SetNumUninitialized(InTargetX * InTargetY);
 
-	for (int32 x0=0; x0<count; x0++)
+	//Source columns [begin, end) of each target column, each one ends where the next begins
+	TArray<int32> ColumnStarts;
+	ColumnStarts.SetNumUninitialized(InTargetX + 1);
+	for (int32 x=0; x<=InTargetX; x++)
 	{
-		float x1 = (x * offset * count) + x0 * offset;
-		int32 prev_x = FMath::Clamp(x1, 0, InSizeX - 1);
-		int32 next_x = FMath::Clamp(prev_x+1, 0, InSizeX-1);
-		float frac_x = x1 - prev_x;
+		ColumnStarts.GetData()[x] = (int32)(((int64)x * InSizeX) / InTargetX);
+	}
 
-		for (int32 y0=0; y0<count; y0++)
-		{
-			float y1 = (y * offset * count) + y0 * offset;
+	const int32 iRowValues = InSizeX * 4;
 
-			int32 prev_y = FMath::Clamp(y1, 0, InSizeY - 1);
-			int32 next_y = FMath::Clamp(prev_y+1, 0, InSizeY-1);
-			float frac_y = y1 - prev_y;
+	TArray<uint32> RowSums;
+	RowSums.SetNumUninitialized(iRowValues);
+
+	const int32 *pColumnStarts = ColumnStarts.GetData();
+	const uint8 *pSource = (const uint8*)InImageData.GetData();
+	uint32 *pRowSums = RowSums.GetData();
+
+	int32 iSourceY = 0;
+	for (int32 y=0; y<InTargetY; y++)
+	{
+		const int32 iEndY = (int32)(((int64)(y + 1) * InSizeY) / InTargetY);
+		const int32 iRows = FMath::Max(iEndY - iSourceY, 1);
 
-			FLinearColor Upper = ((1 - frac_x) * InImageData.GetData()[(prev_y * InSizeX) + prev_x].ReinterpretAsLinear()) + (frac_x * InImageData.GetData()[(prev_y * InSizeX) + next_x].ReinterpretAsLinear());
-			FLinearColor Bottom = ((1 - frac_x) * InImageData.GetData()[(next_y * InSizeX) + prev_x].ReinterpretAsLinear()) + (frac_x * InImageData.GetData()[(next_y * InSizeX) + next_x].ReinterpretAsLinear());
+		FMemory::Memzero(pRowSums, iRowValues * sizeof(uint32));
 
-			TotalColor += ((1.0f - frac_y) * Upper) + (frac_y * Bottom);
+		for (int32 sy=iSourceY; sy<iEndY; sy++)
+		{
+			const uint8 *pRow = pSource + (int64)sy * iRowValues;
+			for (int32 i=0; i<iRowValues; i++)
+			{
+				pRowSums[i] += pRow[i];
+			}
 		}
-	}
 
-	TotalColor = TotalColor / (float)(count * count);
+		FColor *pTarget = OutData.GetData() + y * InTargetX;
+		for (int32 x=0; x<InTargetX; x++)
+		{
+			const int32 iBegin = pColumnStarts[x] * 4;
+			const int32 iEnd = pColumnStarts[x + 1] * 4;
 
-	return TotalColor.ToFColor(false);
+			uint32 Sum[4] = { 0, 0, 0, 0 };
+			for (int32 i=iBegin; i<iEnd; i+=4)
+			{
+				Sum[0] += pRowSums[i];
+				Sum[1] += pRowSums[i + 1];
+				Sum[2] += pRowSums[i + 2];
+				Sum[3] += pRowSums[i + 3];
+			}
+
+			const uint32 iCount = FMath::Max((uint32)((iEnd - iBegin) / 4 * iRows), 1u);
+			const uint32 iHalf = iCount / 2;
+			uint8 *pOut = (uint8*)&pTarget[x];
+			pOut[0] = (uint8)((Sum[0] + iHalf) / iCount);
+			pOut[1] = (uint8)((Sum[1] + iHalf) / iCount);
+			pOut[2] = (uint8)((Sum[2] + iHalf) / iCount);
+			pOut[3] = (uint8)((Sum[3] + iHalf) / iCount);
+		}
+
+		iSourceY = iEndY;
+	}
 }
 
 //=================================================================
-// 
+// The frame is copied and everything else happens on a worker
 //=================================================================
 void USimpleSaveHeader::AcceptScreenshot(int32 InSizeX, int32 InSizeY, const TArray<FColor>& InImageData)
 {
 	if (FilesRequestingScreenshot.Num() == 0)
 		return;
 
-	TArray<FColor> ResizedData;
+	TArray<FString> Filenames = MoveTemp(FilesRequestingScreenshot);
+	FilesRequestingScreenshot.Reset();
+	GEngine->GameViewport->OnScreenshotCaptured().RemoveAll(this);
 
-	int32 TargetWide = 0;
-	int32 TargetTall = 200;
-	if (InSizeY > TargetTall)
+	if (InSizeX <= 0 || InSizeY <= 0 || InImageData.Num() < InSizeX * InSizeY)
 	{
-		float flFraction = (float)InSizeX / (float)InSizeY;
+		UE_LOG(LogTemp, Warning, TEXT("USimpleSaveHeader::AcceptScreenshot: Invalid screenshot!"));
+		return;
+	}
 
-		TargetWide = flFraction * TargetTall;
+	//Make sure the module is loaded on the game thread
+	IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
 
-		float flPerPixel = (float)InSizeY / (float)TargetTall;
+	const int32 iHeight = ScreenshotHeight;
+	const int32 iQuality = ScreenshotQuality;
+	TWeakObjectPtr<class USaveGameInstance> WeakInstance(Cast<USaveGameInstance>(GEngine->GameViewport->GetGameInstance()));
 
-		int32 nCount = 1 + flPerPixel;
+	//Files of an older screenshot must not overwrite these, so they are written once the previous ones are
+	TSharedRef<TPromise<void>> Written = MakeShared<TPromise<void>>();
+	TFuture<void> Previous = MoveTemp(ScreenshotTask);
+	ScreenshotTask = Written->GetFuture();
 
-		float flOffset = flPerPixel / nCount;
+	Async(EAsyncExecution::ThreadPool, [&ImageWrapperModule, WeakInstance, Previous = MoveTemp(Previous), Written, ImageData = InImageData, InSizeX, InSizeY, iHeight, iQuality, Filenames = MoveTemp(Filenames)]() mutable
+	{
+		TArray<FColor> ResizedData;
 
-		//UE_LOG(LogTemp, Display, TEXT("Count %d offset %.2f length %.2f per pixel %.2f"), nCount, flOffset, flOffset * nCount, flPerPixel);
+		int32 TargetWide = InSizeX;
+		int32 TargetTall = InSizeY;
+		if (InSizeY > iHeight)
+		{
+			TargetTall = iHeight;
+			TargetWide = FMath::Max((int32)(((int64)InSizeX * iHeight) / InSizeY), 1);
+			DownscaleScreenshot(InSizeX, InSizeY, ImageData, TargetWide, TargetTall, ResizedData);
+		}
+		else
+		{
+			ResizedData = MoveTemp(ImageData);
+		}
 
-		ResizedData.SetNum( TargetTall * TargetWide );
-	
-		//
-		for (int32 x=0; x<TargetWide; x++)
+		//Thumbnail comes from the scaled screenshot unless it went below the thumbnail size
+		TArray<uint8> ThumbnailBlocks;
+		if (TargetWide >= FScreenshotAtlas::ThumbnailWide && TargetTall >= FScreenshotAtlas::ThumbnailTall)
 		{
-			for (int32 y=0; y<TargetTall; y++)
-			{
-				int32 target = (y * TargetWide) + x;
-				ResizedData.GetData()[target] = GetTotalColor(InSizeX, InSizeY, InImageData, x, y, flOffset, nCount);
-			}
+			FScreenshotAtlas::CompressThumbnail(TargetWide, TargetTall, ResizedData, ThumbnailBlocks);
+		}
+		else
+		{
+			FScreenshotAtlas::CompressThumbnail(InSizeX, InSizeY, ImageData, ThumbnailBlocks);
 		}
-	}
-	else
-	{
-		TargetWide = InSizeX;
-		TargetTall = InSizeY;
 
-		ResizedData = InImageData;
-	}
+		TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::JPEG);
+		ImageWrapper->SetRaw(ResizedData.GetData(), ResizedData.Num() * sizeof(FColor), TargetWide, TargetTall, ERGBFormat::BGRA, 8);
 
-	// Load image wrapper module
-	IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
-	TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::JPEG);
+		TArray64<uint8> JPGData = ImageWrapper->GetCompressed(iQuality);
+
+		auto Write = [WeakInstance, Written, JPGData = MoveTemp(JPGData), ThumbnailBlocks = MoveTemp(ThumbnailBlocks), Filenames = MoveTemp(Filenames)]() mutable
+		{
+			IFileManager* FileManager = &IFileManager::Get();
 
-	// Provide image wrapper with raw pixels (TArray<FColor>)
-	ImageWrapper->SetRaw(&ResizedData[0], ResizedData.Num() * sizeof(FColor), TargetWide, TargetTall, ERGBFormat::BGRA, 8);
+			//Save for each save file that was requesting
+			for (int32 i=0; i<Filenames.Num(); i++)
+			{
+				FString Filename = FPaths::ProjectSavedDir() + FString::Printf(TEXT("SaveGames/Header/%s.jpg"), *Filenames.GetData()[i]);
+
+				FArchive* Ar = FileManager->CreateFileWriter(*Filename);
+				if (Ar != nullptr)
+				{
+					Ar->Serialize((void*)JPGData.GetData(), JPGData.Num());
+					delete Ar;
+
+					UE_LOG(LogTemp, Display, TEXT("Saved screenshot: %s"), *Filename);
+				}
+				else
+				{
+					UE_LOG(LogTemp, Warning, TEXT("Failed to create file writer!"));
+				}
+			}
 
-	// Get the image using 90% JPEG compression
-	const TArray64<uint8>& PNGData = ImageWrapper->GetCompressed(100);
+			//Same thumbnail for each of them in the atlas
+			if (ThumbnailBlocks.Num() > 0)
+			{
+				FScreenshotAtlas Atlas;
+				Atlas.Load();
+				for (int32 i=0; i<Filenames.Num(); i++)
+				{
+					Atlas.SetThumbnail(Filenames.GetData()[i], ThumbnailBlocks);
+				}
+				Atlas.Save();
+			}
 
-	IFileManager* FileManager = &IFileManager::Get();
+			//Anything decoded before the files were written is out of date
+			AsyncTask(ENamedThreads::GameThread, [WeakInstance, Filenames = MoveTemp(Filenames)]()
+			{
+				if (WeakInstance.IsValid())
+				{
+					WeakInstance->OnScreenshotsWritten(Filenames);
+				}
+			});
 
-	//Save for each save file that is currently requesting
-	for (int32 i=0; i< FilesRequestingScreenshot.Num(); i++)
-	{
-		FString Filename = FPaths::ProjectSavedDir() + FString::Printf(TEXT("SaveGames/Header/%s.jpg"), *FilesRequestingScreenshot.GetData()[i]);
+			Written->SetValue();
+		};
 
-		FArchive* Ar = FileManager->CreateFileWriter(Filename.GetCharArray().GetData());
-		if (Ar != nullptr)
+		//A continuation of the previous write instead of waiting on it, so no worker is blocked by another
+		if (Previous.IsValid())
 		{
-			Ar->Serialize((void*)PNGData.GetData(), PNGData.GetAllocatedSize());
-			delete Ar;
-
-			UE_LOG(LogTemp, Display, TEXT("Saved screenshot: %s"), *Filename);
+			Previous.Then([Write = MoveTemp(Write)](TFuture<void>) mutable
+			{
+				Write();
+			});
 		}
 		else
 		{
-			UE_LOG(LogTemp, Warning, TEXT("Failed to create file writer!"));
+			Write();
 		}
-	}
-
-	FilesRequestingScreenshot.Reset();
-	GEngine->GameViewport->OnScreenshotCaptured().RemoveAll(this);
+	});
 }
\ No newline at end of file
@@ -0,0 +1,211 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#include "Saving/SimpleSavePrefetch.h"
+#include "Saving/SimpleSaveFile.h"
+#include "Kismet/GameplayStatics.h"
+#include "PlatformFeatures.h"
+#include "SaveGameSystem.h"
+#include "Async/Async.h"
+#include "Containers/Ticker.h"
+
+//=================================================================
+// 
+//=================================================================
+void USimpleSavePrefetch::Prefetch(const FString &Filename)
+{
+	if (Filename.IsEmpty() || IsPrefetching(Filename) || WritingFiles.Contains(Filename))
+		return;
+
+	Cancel();
+
+	//Make sure the save system exists before the worker asks for it
+	ISaveGameSystem *pSaveSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem();
+	if (!pSaveSystem)
+		return;
+
+	PrefetchFilename = Filename;
+
+	TWeakObjectPtr<USimpleSavePrefetch> WeakThis(this);
+	const int32 iGeneration = Generation;
+
+	//Not loaded in time, a newer prefetch or taking the save changes the generation
+	if (Timeout > 0.0f)
+	{
+		FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this, iGeneration](float InDeltaTime)
+		{
+			if (iGeneration == Generation)
+			{
+				Cancel();
+			}
+			return false;
+		}), Timeout);
+	}
+
+	ReadTask = Async(EAsyncExecution::ThreadPool, [pSaveSystem, Filename]()
+	{
+		TArray<uint8> FileData;
+		pSaveSystem->LoadGame(false, *Filename, 0, FileData);
+		return FileData;
+	},
+	[WeakThis, iGeneration]()
+	{
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, iGeneration]()
+		{
+			if (WeakThis.IsValid())
+			{
+				WeakThis->OnReadFinished(iGeneration);
+			}
+		});
+	});
+}
+
+//=================================================================
+// 
+//=================================================================
+void USimpleSavePrefetch::OnReadFinished(int32 InGeneration)
+{
+	//Cancelled or taken since
+	if (InGeneration != Generation || !ReadTask.IsValid())
+		return;
+
+	TArray<uint8> FileData = ReadTask.Consume();
+	SaveFile = Cast<USimpleSaveFile>(UGameplayStatics::LoadGameFromMemory(FileData));
+	if (!SaveFile)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("USimpleSavePrefetch::OnReadFinished: Failed to read \"%s\""), *PrefetchFilename);
+		return;
+	}
+
+	StartLoads();
+}
+
+//=================================================================
+// Classes of the actors and objects in the saved map and the assets
+// they reference, those already in memory are skipped
+//=================================================================
+void USimpleSavePrefetch::StartLoads()
+{
+	TArray<TSoftClassPtr<UObject>> Classes;
+	SaveFile->GatherClassesForMap(SaveFile->GetCurrentLevelName(), Classes);
+
+	TArray<FSoftObjectPath> Paths;
+	Paths.Reserve(Classes.Num() + SaveFile->GetAssetsToLoad().Num());
+
+	for (int32 i=0; i<Classes.Num(); i++)
+	{
+		if (Classes.GetData()[i].IsPending())
+		{
+			Paths.Add(Classes.GetData()[i].ToSoftObjectPath());
+		}
+	}
+
+	const int32 iPendingClasses = Paths.Num();
+
+	const TArray<TSoftObjectPtr<UObject>> &Assets = SaveFile->GetAssetsToLoad();
+	for (int32 i=0; i<Assets.Num(); i++)
+	{
+		if (Assets.GetData()[i].IsPending())
+		{
+			Paths.Add(Assets.GetData()[i].ToSoftObjectPath());
+		}
+	}
+
+	if (Paths.Num() == 0)
+		return;
+
+	UE_LOG(LogTemp, Verbose, TEXT("Prefetching \"%s\": %d classes and %d assets"), *PrefetchFilename, iPendingClasses, Paths.Num() - iPendingClasses);
+
+	LoadHandle = StreamableManager.RequestAsyncLoad(MoveTemp(Paths), FStreamableDelegate(), LoadPriority);
+}
+
+//=================================================================
+// 
+//=================================================================
+void USimpleSavePrefetch::Cancel()
+{
+	Generation++;
+	PrefetchFilename.Reset();
+	SaveFile = NULL;
+
+	//Can't stop the read, the result is ignored
+	ReadTask = TFuture<TArray<uint8>>();
+
+	if (LoadHandle.IsValid())
+	{
+		LoadHandle->CancelHandle();
+		LoadHandle.Reset();
+	}
+}
+
+//=================================================================
+// 
+//=================================================================
+void USimpleSavePrefetch::CancelFor(const FString &Filename)
+{
+	if (IsPrefetching(Filename))
+	{
+		Cancel();
+	}
+}
+
+//=================================================================
+// 
+//=================================================================
+class USimpleSaveFile *USimpleSavePrefetch::TakeSaveFile(const FString &Filename)
+{
+	if (!IsPrefetching(Filename))
+	{
+		Cancel();
+		return NULL;
+	}
+
+	//Clicked before the read finished, it is still further along than a new read
+	if (!SaveFile && ReadTask.IsValid())
+	{
+		OnReadFinished(Generation);
+	}
+
+	class USimpleSaveFile *pSaveFile = SaveFile;
+
+	ReleaseLoads();
+	KeptHandle = MoveTemp(LoadHandle);
+	LoadHandle.Reset();
+
+	//Nothing to cancel anymore
+	Generation++;
+	PrefetchFilename.Reset();
+	SaveFile = NULL;
+
+	return pSaveFile;
+}
+
+//=================================================================
+// 
+//=================================================================
+void USimpleSavePrefetch::BeginWrite(const FString &Filename)
+{
+	CancelFor(Filename);
+	WritingFiles.Add(Filename);
+}
+
+//=================================================================
+// 
+//=================================================================
+void USimpleSavePrefetch::EndWrite(const FString &Filename)
+{
+	WritingFiles.Remove(Filename);
+}
+
+//=================================================================
+// 
+//=================================================================
+void USimpleSavePrefetch::ReleaseLoads()
+{
+	if (KeptHandle.IsValid())
+	{
+		KeptHandle->ReleaseHandle();
+		KeptHandle.Reset();
+	}
+}
@@ -3,6 +3,8 @@
 // Do not use to train AI / LLM / neural network
 
 #include "Widgets/SaveFileWidget.h"
+#include "Saving/SaveGameInstance.h"
+#include "Saving/SimpleSavePrefetch.h"
 
 //=================================================================
 // 
@@ -14,6 +16,16 @@ void USaveFileWidget::Setup(const FSaveFileList &InFile)
 	OnSetup();
 }
 
+//=================================================================
+// 
+//=================================================================
+void USaveFileWidget::Release()
+{
+	OnRelease();
+	Filename.Reset();
+	DateTime = FDateTime();
+}
+
 //=================================================================
 // 
 //=================================================================
@@ -21,4 +33,54 @@ void USaveFileWidget::Click()
 {
 	OnClicked();
 	OnClick.Broadcast(Filename);
+}
+
+//=================================================================
+// 
+//=================================================================
+void USaveFileWidget::StartPrefetch()
+{
+	class USaveGameInstance *pGameInstance = GetGameInstance<USaveGameInstance>();
+	if (IsValid(pGameInstance) && !Filename.IsEmpty())
+	{
+		pGameInstance->GetSavePrefetch()->Prefetch(Filename);
+	}
+}
+
+//=================================================================
+// 
+//=================================================================
+void USaveFileWidget::StopPrefetch()
+{
+	class USaveGameInstance *pGameInstance = GetGameInstance<USaveGameInstance>();
+	if (IsValid(pGameInstance) && !Filename.IsEmpty())
+	{
+		pGameInstance->GetSavePrefetch()->CancelFor(Filename);
+	}
+}
+
+//=================================================================
+// 
+//=================================================================
+void USaveFileWidget::NativeOnMouseEnter(const FGeometry &InGeometry, const FPointerEvent &InMouseEvent)
+{
+	Super::NativeOnMouseEnter(InGeometry, InMouseEvent);
+
+	if (PrefetchOnHover)
+	{
+		StartPrefetch();
+	}
+}
+
+//=================================================================
+// 
+//=================================================================
+void USaveFileWidget::NativeOnAddedToFocusPath(const FFocusEvent &InFocusEvent)
+{
+	Super::NativeOnAddedToFocusPath(InFocusEvent);
+
+	if (PrefetchOnHover)
+	{
+		StartPrefetch();
+	}
 }
\ No newline at end of file
@@ -4,8 +4,14 @@
 
 
 #include "Widgets/SaveFileWidgetList.h"
+#include "Widgets/SaveFileWidget.h"
+#include "Saving/SaveGameInstance.h"
+#include "Kismet/GameplayStatics.h"
 #include "UMG/Public/Blueprint/WidgetBlueprintLibrary.h"
+#include "UMG/Public/Blueprint/WidgetLayoutLibrary.h"
 #include "UMG/Public/Components/PanelWidget.h"
+#include "UMG/Public/Components/ScrollBox.h"
+#include "UMG/Public/Components/Spacer.h"
 
 //=================================================================
 // 
@@ -22,6 +28,15 @@ void USaveFileWidgetList::NativeDestruct()
 //=================================================================
 void USaveFileWidgetList::DestroyList()
 {
+	//Rows still showing a save hold its screenshot and may be decoding one, pooled rows were released already
+	for (auto It = VisibleWidgets.CreateConstIterator(); It; ++It)
+	{
+		if (IsValid(It.Value()))
+		{
+			It.Value()->Release();
+		}
+	}
+
 	//
 	for (int32 i=0; i<Widgets.Num(); i++)
 	{
@@ -31,7 +46,26 @@ void USaveFileWidgetList::DestroyList()
 		}
 	}
 
+	if (IsValid(TopSpacer))
+	{
+		TopSpacer->RemoveFromParent();
+	}
+
+	if (IsValid(BottomSpacer))
+	{
+		BottomSpacer->RemoveFromParent();
+	}
+
+	if (ScrollBox.IsValid())
+	{
+		ScrollBox->OnUserScrolled.RemoveDynamic(this, &USaveFileWidgetList::OnListScrolled);
+	}
+
 	Widgets.Reset();
+	VisibleWidgets.Reset();
+	Pool.Reset();
+	Parent.Reset();
+	ScrollBox.Reset();
 }
 
 //=================================================================
@@ -73,94 +107,203 @@ bool USaveFileWidgetList::UpdateList(TSoftClassPtr<class USaveFileWidget> InClas
 		PlayerController = pController;
 	}
 
-	pGameInstance->GenerateSaveFileList();
-
-	TMap<FString, class USaveFileWidget*> CachedWidgets;
+	if (!IsValid(InParent))
+		return false;
 
-	bool bFilesMissing = false;
+	WidgetClass = InClass.IsPending() ? InClass.LoadSynchronous() : InClass.Get();
+	if (!WidgetClass)
+		return false;
 
-	//Figure out if each file has a widget already or not
-	const TArray<FSaveFileList> &List = pGameInstance->GetSaveFiles();
-	for (int32 i=0; i<List.Num(); i++)
+	//Moved to another panel
+	if (Parent.Get() != InParent)
 	{
-		const FSaveFileList &File = List.GetData()[i];
+		DestroyList();
+		Parent = InParent;
 
-		class USaveFileWidget *pWidget = NULL;
-		for (int32 j=0; j<Widgets.Num(); j++)
+		//Nearest scroll box the list is in
+		for (class UWidget *pWidget = InParent; pWidget; pWidget = pWidget->GetParent())
 		{
-			if (Widgets.GetData()[j]->GetFilename().Equals(File.Filename, ESearchCase::IgnoreCase))
+			if (class UScrollBox *pScrollBox = Cast<UScrollBox>(pWidget))
 			{
-				pWidget = Widgets.GetData()[j];
+				ScrollBox = pScrollBox;
+				pScrollBox->OnUserScrolled.AddUniqueDynamic(this, &USaveFileWidgetList::OnListScrolled);
 				break;
 			}
 		}
+	}
+
+	pGameInstance->GenerateSaveFileList();
+
+	return UpdateRows();
+}
+
+//=================================================================
+// 
+//=================================================================
+void USaveFileWidgetList::OnListScrolled(float CurrentOffset)
+{
+	UpdateRows();
+}
+
+//=================================================================
+// Assumes the list starts at the top of the scrolled content
+//=================================================================
+void USaveFileWidgetList::GetVisibleRows(int32 InNum, int32 &OutFirst, int32 &OutEnd) const
+{
+	OutFirst = 0;
+	OutEnd = InNum;
+
+	class UScrollBox *pScrollBox = ScrollBox.Get();
+	if (RowHeight <= 0.0f || !pScrollBox)
+		return;
+
+	const float fOffset = pScrollBox->GetScrollOffset();
+
+	//Not laid out yet on the first frame
+	float fHeight = pScrollBox->GetCachedGeometry().GetLocalSize().Y;
+	if (fHeight <= 0.0f)
+	{
+		fHeight = UWidgetLayoutLibrary::GetViewportSize(this).Y / FMath::Max(UWidgetLayoutLibrary::GetViewportScale(this), KINDA_SMALL_NUMBER);
+	}
+
+	OutFirst = FMath::Clamp(FMath::FloorToInt(fOffset / RowHeight) - ExtraRows, 0, InNum);
+	OutEnd = FMath::Clamp(FMath::CeilToInt((fOffset + fHeight) / RowHeight) + ExtraRows, OutFirst, InNum);
+}
+
+//=================================================================
+// 
+//=================================================================
+class USaveFileWidget *USaveFileWidgetList::TakeWidget()
+{
+	while (Pool.Num() > 0)
+	{
+		class USaveFileWidget *pWidget = Pool.Pop(false);
+		if (IsValid(pWidget))
+			return pWidget;
+	}
+
+	class USaveFileWidget *pWidget = Cast<USaveFileWidget>(UWidgetBlueprintLibrary::Create(PlayerController.Get(), WidgetClass, PlayerController.Get()));
 
-		if (pWidget)
+	//Start listening to event
+	if (IsValid(pWidget))
+	{
+		Widgets.Add(pWidget);
+		pWidget->OnClick.AddDynamic(this, &USaveFileWidgetList::OnFileClicked);
+	}
+
+	return pWidget;
+}
+
+//=================================================================
+// 
+//=================================================================
+void USaveFileWidgetList::PlaceChild(class UWidget *InWidget, int32 InIndex)
+{
+	class UPanelWidget *pParent = Parent.Get();
+	if (InWidget->GetParent() != pParent)
+	{
+		InWidget->RemoveFromParent();
+		pParent->InsertChildAt(InIndex, InWidget);
+	}
+	else if (pParent->GetChildIndex(InWidget) != InIndex)
+	{
+		pParent->ShiftChild(InIndex, InWidget);
+	}
+}
+
+//=================================================================
+// 
+//=================================================================
+bool USaveFileWidgetList::UpdateRows()
+{
+	class USaveGameInstance *pGameInstance = GameInstance.Get();
+	class UPanelWidget *pParent = Parent.Get();
+	if (!IsValid(pGameInstance) || !IsValid(pParent) || !WidgetClass)
+		return false;
+
+	const TArray<FSaveFileList> &List = pGameInstance->GetSaveFiles();
+
+	int32 iFirst = 0;
+	int32 iEnd = 0;
+	GetVisibleRows(List.Num(), iFirst, iEnd);
+
+	//Keep the widgets of rows still in view
+	TMap<FString, class USaveFileWidget*> Previous = MoveTemp(VisibleWidgets);
+	VisibleWidgets.Reset();
+	for (int32 i=iFirst; i<iEnd; i++)
+	{
+		class USaveFileWidget *pWidget = NULL;
+		if (Previous.RemoveAndCopyValue(List.GetData()[i].Filename, pWidget) && IsValid(pWidget))
 		{
-			CachedWidgets.Emplace(File.Filename, pWidget);
+			VisibleWidgets.Emplace(List.GetData()[i].Filename, pWidget);
 		}
-		else
+	}
+
+	//Removes
+	for (TMap<FString, class USaveFileWidget*>::TIterator It(Previous); It; ++It)
+	{
+		class USaveFileWidget *pWidget = It.Value();
+		if (IsValid(pWidget))
 		{
-			bFilesMissing = true;
+			pWidget->RemoveFromParent();
+			pWidget->Release();
+			Pool.Add(pWidget);
 		}
 	}
 
-	//If any files missing, need to reorganize
-	if (bFilesMissing)
+	//Inserts and moves, only rows that came into view or were saved over are set up again
+	int32 iChild = 0;
+	if (RowHeight > 0.0f)
 	{
-		TSubclassOf<class USaveFileWidget> WidgetClass = InClass.IsPending() ? InClass.LoadSynchronous() : InClass.Get();
-		if (!WidgetClass)
-			return false;
-
-		//
-		for (int32 i=Widgets.Num()-1; i>=0; i--)
+		if (!IsValid(TopSpacer))
 		{
-			if (!IsValid(Widgets.GetData()[i]))
-			{
-				Widgets.RemoveAt(i);
-				continue;
-			}
+			TopSpacer = NewObject<USpacer>(this);
+		}
 
-			//Check if no longer in list
-			if (!CachedWidgets.Contains(Widgets.GetData()[i]->GetFilename()))
-			{
-				Widgets.GetData()[i]->RemoveFromParent();
-				Widgets.RemoveAt(i);
+		TopSpacer->SetSize(FVector2D(0.0f, iFirst * RowHeight));
+		PlaceChild(TopSpacer, iChild++);
+	}
+	else if (IsValid(TopSpacer))
+	{
+		TopSpacer->RemoveFromParent();
+	}
+
+	for (int32 i=iFirst; i<iEnd; i++)
+	{
+		const FSaveFileList &File = List.GetData()[i];
+
+		class USaveFileWidget *pWidget = VisibleWidgets.FindRef(File.Filename);
+		if (!pWidget)
+		{
+			pWidget = TakeWidget();
+			if (!pWidget)
 				continue;
-			}
 
-			//Unparent
-			Widgets.GetData()[i]->RemoveFromParent();
+			VisibleWidgets.Emplace(File.Filename, pWidget);
+			pWidget->Setup(File);
 		}
-
-		//Now create and reorganize the files
-		for (int32 i=0; i<List.Num(); i++)
+		else if (pWidget->GetDateTime() != File.DateTime)
 		{
-			class USaveFileWidget *pWidget = NULL;
-			
-			if (CachedWidgets.Contains(List.GetData()[i].Filename))
-			{
-				pWidget = CachedWidgets[List.GetData()[i].Filename];
-			}
-			else
-			{
-				pWidget = Cast<USaveFileWidget>(UWidgetBlueprintLibrary::Create(pController, WidgetClass, pController));
-
-				//Start listening to event
-				if (IsValid(pWidget))
-				{
-					Widgets.Add(pWidget);
-					pWidget->OnClick.AddDynamic(this, &USaveFileWidgetList::OnFileClicked);
-				}
-			}
+			pWidget->Setup(File);
+		}
 
-			if (IsValid(pWidget))
-			{
-				InParent->AddChild(pWidget);
-				pWidget->Setup(List.GetData()[i]);
-			}
+		PlaceChild(pWidget, iChild++);
+	}
+
+	if (RowHeight > 0.0f)
+	{
+		if (!IsValid(BottomSpacer))
+		{
+			BottomSpacer = NewObject<USpacer>(this);
 		}
+
+		BottomSpacer->SetSize(FVector2D(0.0f, (List.Num() - iEnd) * RowHeight));
+		PlaceChild(BottomSpacer, iChild++);
+	}
+	else if (IsValid(BottomSpacer))
+	{
+		BottomSpacer->RemoveFromParent();
 	}
 
-	return Widgets.Num() > 0;
-}
\ No newline at end of file
+	return VisibleWidgets.Num() > 0;
+}
@@ -52,6 +52,18 @@ struct FSimpleSaveData
 	FORCEINLINE int32 GetCount() const { return Singles.Num() + Arrays.Num() + Maps.Num(); }
 };
 
+//==============================================================================================================
+// State of a placed actor or component when the level was loaded
+//==============================================================================================================
+struct FSimpleLevelBaseline
+{
+	//Relative transform for components
+	FTransform Transform;
+
+	//
+	FSimpleSaveData Data;
+};
+
 //==============================================================================================================
 // No saving object properties
 //==============================================================================================================
@@ -107,6 +119,29 @@ public:
 		return OutString;
 	}
 
+	//Checks against a full "Parent.Tag" tag without creating a name for it
+	bool MatchesTag(const FName &InTag) const;
+
+	//Same as above with the tag already split, use when comparing many records against the same tag
+	bool MatchesTag(const FName &InTag, const FName &InSplitParentTag, const FName &InSplitTag) const;
+
+	//Splits "Parent.Tag" at the last dot, only finds existing names so the parts are none when nothing could match
+	static void SplitTag(const FName &InTag, FName &OutParentTag, FName &OutTag);
+
+	//Full tag of a child record, used as the parent tag of anything under it so nested tags stay unique
+	static FName MakeChildTag(const FName &InParentTag, const FName &InTag);
+
+	//Checks that this belongs to the parent with the local tag, also works with saves that stored the full tag
+	bool IsChildTag(const FName &InParentTag, const FName &InTag) const;
+
+	//Full tag for displaying only
+	FString GetTagString() const;
+
+	//Records with identical values keep them in shared payloads of the level or the save file
+	FORCEINLINE const TMap<FName, FString> &GetSingles(const TArray<FSimpleSaveData> &InPayloads) const { return InPayloads.IsValidIndex(PayloadIndex) ? InPayloads.GetData()[PayloadIndex].Singles : Singles; }
+	FORCEINLINE const TMap<FName, FArrayData> &GetArrays(const TArray<FSimpleSaveData> &InPayloads) const { return InPayloads.IsValidIndex(PayloadIndex) ? InPayloads.GetData()[PayloadIndex].Arrays : Arrays; }
+	FORCEINLINE const TMap<FName, FMapData> &GetMaps(const TArray<FSimpleSaveData> &InPayloads) const { return InPayloads.IsValidIndex(PayloadIndex) ? InPayloads.GetData()[PayloadIndex].Maps : Maps; }
+
 public:
 
 	//
@@ -127,6 +162,10 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	FName Tag = NAME_None;
 
+	//Full tag of the record this belongs to, Tag is then only unique within the parent
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FName ParentTag = NAME_None;
+
 	//
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	TSoftClassPtr<class UObject> Class = NULL;
@@ -147,10 +186,81 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	bool Recreate = false;
 
+	//Hash of the saveable properties of the class when this was saved, zero if unknown
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 SchemaHash = 0;
+
+	//Index of the shared payload that holds the values instead of this record
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 PayloadIndex = INDEX_NONE;
+
+	//Shared payload is in the save file instead of the level
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	bool PayloadIsGlobal = false;
+
 	//
 	FORCEINLINE int32 GetCount() const { return Singles.Num() + Arrays.Num() + Maps.Num(); }
 };
 
+//==============================================================================================================
+// Transform that is only written when it matters, quantized if asked to
+//==============================================================================================================
+USTRUCT(BlueprintType)
+struct FSavedTransform
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	//
+	FORCEINLINE bool IsSet() const { return bIsSet; }
+
+	//
+	FORCEINLINE const FTransform &Get() const { return Transform; }
+
+	//Quantized transforms use a smallest three rotation and float scale in the save file, positions are always doubles
+	void Set(const FTransform &InTransform, bool InQuantize);
+
+	//Nothing is written and restoring leaves the transform alone
+	FORCEINLINE void Reset() 
+	{ 
+		Transform = FTransform::Identity; 
+		bIsSet = false; 
+		bQuantize = false;
+	}
+
+	//
+	bool Serialize(FArchive &Ar);
+
+	//Saves made before this struct stored a plain FTransform
+	bool SerializeFromMismatchedTag(const struct FPropertyTag &Tag, FStructuredArchive::FSlot Slot);
+
+	//Unset transforms match anything since they won't be restored
+	FORCEINLINE bool Equals(const FTransform &InTransform) const { return !bIsSet || Transform.Equals(InTransform); }
+
+private:
+
+	//
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta=(AllowPrivateAccess=true))
+	FTransform Transform;
+
+	//
+	bool bIsSet = false;
+
+	//
+	bool bQuantize = false;
+};
+
+template<>
+struct TStructOpsTypeTraits<FSavedTransform> : public TStructOpsTypeTraitsBase2<FSavedTransform>
+{
+	enum
+	{
+		WithSerializer = true,
+		WithStructuredSerializeFromMismatchedTag = true,
+	};
+};
+
 //==============================================================================================================
 //
 //==============================================================================================================
@@ -159,9 +269,9 @@ struct FComponentSaveData
 {
 	GENERATED_USTRUCT_BODY()
 
-	//
+	//Relative transform, only for movable scene components
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
-	FTransform Transform;
+	FSavedTransform Transform;
 
 	//
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
@@ -176,13 +286,13 @@ struct FActorSaveData
 {
 	GENERATED_USTRUCT_BODY()
 
-	//
+	//Only for movable or recreated actors
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
-	FTransform Transform;
+	FSavedTransform Transform;
 
-	//
+	//Only for attached actors
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
-	FTransform RelativeTransform;
+	FSavedTransform RelativeTransform;
 
 	//
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
@@ -214,6 +324,44 @@ struct FLevelSaveData
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	TArray<FCustomSaveData> CustomObjects;
 
+	//Values of records in this level that were identical to each other
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	TArray<FSimpleSaveData> SharedPayloads;
+
 	UPROPERTY(VisibleAnywhere)
 	float SaveTime = 0.0f;
+
+	//Unchanged placed actors were left out, so it can only be restored over a freshly loaded level
+	UPROPERTY(VisibleAnywhere)
+	bool DeltaSaved = false;
+
+	//Actors followed by custom objects serialized into one blob while the level isn't played
+	UPROPERTY()
+	TArray<uint8> PackedData;
+
+	//Offset of each packed record in PackedData
+	UPROPERTY()
+	TArray<int32> PackedOffsets;
+
+	//
+	UPROPERTY()
+	int32 PackedActors = 0;
+
+	//
+	FORCEINLINE bool IsPacked() const { return PackedOffsets.Num() > 0; }
+
+	//
+	void Pack();
+
+	//
+	void Unpack();
+
+	//Drops the records whether they are packed or not, for saving the level again
+	void ResetRecords();
+
+	//Reads a single actor without unpacking the level
+	bool GetPackedActor(int32 InIndex, FActorSaveData &OutData) const;
+
+	//Reads a single custom object without unpacking the level
+	bool GetPackedObject(int32 InIndex, FCustomSaveData &OutData) const;
 };
\ No newline at end of file
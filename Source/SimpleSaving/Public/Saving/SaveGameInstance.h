@@ -9,6 +9,9 @@
 #include "SaveFileList.h"
 #include "GameplayTagContainer.h"
 #include "SimpleHeaderData.h"
+#include "SaveData.h"
+#include "UObject/ObjectKey.h"
+#include "ScreenshotCache.h"
 #include "SaveGameInstance.generated.h"
 
 //=================================================================
@@ -64,7 +67,7 @@ public:
 	virtual void GetLocalActorTags(class APlayerController *InController, class APawn *InPawn, TMap<FName, class AActor*> &OutActors) { }
 
 	//
-	void StartLoading(class USimpleSaveFile *InLoadGame);
+	void StartLoading(class USimpleSaveFile *InLoadGame, bool InRestoreInPlace = false);
 
 	//
 	void SetSaveGame(class USimpleSaveFile *InSaveGame);
@@ -74,6 +77,7 @@ public:
 
 	//
 	FORCEINLINE bool IsLoading() const { return LoadGame != NULL && bIsLoading; }
+	FORCEINLINE bool IsRestoringInPlace() const { return IsLoading() && bRestoringInPlace; }
 	FORCEINLINE class USimpleSaveFile *GetLoadGame() const { return LoadGame; }
 
 	//
@@ -105,6 +109,9 @@ private:
 	UPROPERTY(VisibleAnywhere, Category="Saving", BlueprintReadOnly, meta=(AllowPrivateAccess=true))
 	bool bIsLoading;
 
+	//Restoring a checkpoint over the current level without reopening it
+	bool bRestoringInPlace = false;
+
 #if WITH_EDITORONLY_DATA
 	//
 	UPROPERTY()
@@ -115,6 +122,98 @@ private:
 	bool DebugSaving = false;
 #endif //
 
+	//Transforms are saved with float positions and compressed rotations
+	UPROPERTY(EditAnywhere, Category="Saving", BlueprintReadOnly, meta=(AllowPrivateAccess=true))
+	bool QuantizeTransforms = true;
+
+public:
+
+	//
+	FORCEINLINE bool UseQuantizedTransforms() const { return QuantizeTransforms; }
+
+	//
+	FORCEINLINE bool UseInPlaceRestore() const { return InPlaceRestore; }
+
+	//
+	FORCEINLINE bool UseInPlaceCheckpoints() const { return InPlaceCheckpoints; }
+
+private:
+
+	//Saves of the current map are restored over the level without reopening it. Actors without the save
+	//interface and values that aren't saved then keep their current state instead of the loaded one
+	UPROPERTY(EditAnywhere, Category="Saving", BlueprintReadOnly, meta=(AllowPrivateAccess=true))
+	bool InPlaceRestore = false;
+
+	//Same as above for checkpoints and rewinding, which are meant to skip reopening the map
+	UPROPERTY(EditAnywhere, Category="Saving", BlueprintReadOnly, meta=(AllowPrivateAccess=true))
+	bool InPlaceCheckpoints = true;
+
+	//=================================================================
+	// DELTA SAVING
+	//=================================================================
+public:
+
+	//Remembers the state of the placed actors of the current level, called on restore when delta saving
+	UFUNCTION(BlueprintCallable, meta=(WorldContext="WorldContextObject"))
+	void CaptureLevelBaseline(class UObject *WorldContextObject);
+
+	//
+	FORCEINLINE bool UseDeltaSaving() const { return DeltaSaving; }
+
+	//
+	FORCEINLINE bool HasLevelBaseline(const FName &InLevel) const { return !BaselineLevel.IsNone() && BaselineLevel == InLevel; }
+
+	//
+	FORCEINLINE const FSimpleLevelBaseline *FindLevelBaseline(const class UObject *InObject) const { return LevelBaseline.Find(InObject); }
+
+private:
+
+	//Placed actors only save what changed since the level was loaded. The loaded values of every placed
+	//saveable actor and its components are kept in memory while the level is played to compare against
+	UPROPERTY(EditAnywhere, Category="Saving", BlueprintReadOnly, meta=(AllowPrivateAccess=true))
+	bool DeltaSaving = false;
+
+	//
+	FName BaselineLevel;
+
+	//
+	TMap<TObjectKey<class UObject>, FSimpleLevelBaseline> LevelBaseline;
+
+	//=================================================================
+	// CHECKPOINTS
+	//=================================================================
+public:
+
+	//
+	FORCEINLINE bool HasCheckpoint() const { return Checkpoint.Num() > 0; }
+	FORCEINLINE const TArray<uint8> &GetCheckpoint() const { return Checkpoint; }
+	FORCEINLINE void SetCheckpoint(TArray<uint8> &&InCheckpoint) { Checkpoint = MoveTemp(InCheckpoint); }
+
+	//
+	UFUNCTION(BlueprintCallable)
+	void ClearCheckpoint() { Checkpoint.Empty(); }
+
+	//
+	UFUNCTION(BlueprintCallable)
+	class USimpleRewindBuffer *GetRewindBuffer();
+
+	//
+	UFUNCTION(BlueprintCallable)
+	class USimpleSavePrefetch *GetSavePrefetch();
+
+private:
+
+	//Serialized save file from USimpleSaveFile::CaptureCheckpoint
+	TArray<uint8> Checkpoint;
+
+	//
+	UPROPERTY(Transient)
+	class USimpleRewindBuffer *RewindBuffer = NULL;
+
+	//
+	UPROPERTY(Transient)
+	class USimpleSavePrefetch *SavePrefetch = NULL;
+
 	//=================================================================
 	// LEVEL CHANGE - FUNCTIONS
 	//=================================================================
@@ -182,6 +281,9 @@ public:
 	//
 	FORCEINLINE const TArray<FSaveFileList> &GetSaveFiles() const { return SaveFiles; }
 
+	//Time the save file was written, or none if it isn't in the list
+	FDateTime GetSaveFileTime(const FString &InFilename) const;
+
 private:
 
 	//
@@ -217,6 +319,35 @@ public:
 	UPROPERTY(Transient)
 	class USimpleSaveHeader *SaveHeaderData = NULL;
 
+	//Height the screenshot of each save is scaled down to
+	UPROPERTY(EditAnywhere, Category="Saving")
+	int32 ScreenshotHeight = 200;
+
+	//JPEG quality of the screenshot, 1 - 100
+	UPROPERTY(EditAnywhere, Category="Saving")
+	int32 ScreenshotQuality = 85;
+
+	//Memory decoded screenshots of the save files can take
+	UPROPERTY(EditAnywhere, Category="Saving")
+	int32 ScreenshotCacheKilobytes = 8 * 1024;
+
+	//
+	FScreenshotCache &GetScreenshotCache();
+
+	//Screenshots and the thumbnail atlas of these save files were written
+	void OnScreenshotsWritten(const TArray<FString> &InFilenames);
+
+	//Changes each time the thumbnail atlas is written
+	FORCEINLINE int32 GetScreenshotAtlasVersion() const { return ScreenshotAtlasVersion; }
+
+private:
+
+	//Kept while the game runs so reopening the menu doesn't decode them again
+	FScreenshotCache ScreenshotCache;
+
+	//
+	int32 ScreenshotAtlasVersion = 0;
+
 	//==============================================================================================================
 	// DELEGATES
 	//==============================================================================================================
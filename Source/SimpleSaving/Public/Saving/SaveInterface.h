@@ -57,9 +57,18 @@ public:
 	//
 	virtual void Runtime_PostSave() { }
 
-	//
+	//Recreated actors get this before BeginPlay
 	virtual void PreRestore() { }
 
+	//Allows reusing this actor for a recreated actor of the same class instead of destroying it on restore
+	virtual bool CanBePooled() const { return false; }
+
+	//Called after the actor has been hidden and disabled for reuse
+	virtual void OnReturnedToPool() { }
+
+	//Called before saved data is restored to a reused actor, reset any state that isn't saved here
+	virtual void OnTakenFromPool() { }
+
 	//
 	virtual void OnRestore(class USaveGameInstance *InGameInstance, class APlayerController *InController) { }
 
@@ -0,0 +1,69 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+//=============================================================================================================================
+// Small DXT1 thumbnails of every save in one file, indexed by save slot. The save browser reads the file once and shows
+// each save as a region of one texture instead of decoding a screenshot per save.
+//=============================================================================================================================
+class SIMPLESAVING_API FScreenshotAtlas
+{
+public:
+
+	//Size of each thumbnail, whole 4x4 blocks
+	static constexpr int32 ThumbnailWide = 128;
+	static constexpr int32 ThumbnailTall = 72;
+
+	//Thumbnails on each row of the atlas texture
+	static constexpr int32 Columns = 16;
+
+	//
+	static FString GetAtlasFilename();
+
+	//
+	static int32 GetThumbnailBytes();
+
+	//Scales the screenshot to the thumbnail size and compresses it
+	static bool CompressThumbnail(int32 InSizeX, int32 InSizeY, const TArray<FColor> &InImageData, TArray<uint8> &OutBlocks);
+
+public:
+
+	//
+	bool Load();
+
+	//Also drops thumbnails of save files that no longer exist
+	bool Save();
+
+	//
+	void SetThumbnail(const FString &InSlot, const TArray<uint8> &InBlocks);
+
+	//
+	int32 Find(const FString &InSlot) const;
+
+	//
+	FORCEINLINE int32 Num() const { return Slots.Num(); }
+
+	//
+	class UTexture2D *CreateTexture() const;
+
+	//
+	FBox2f GetRegion(int32 InIndex) const;
+
+private:
+
+	//
+	static void CompressBlock(const FColor *InPixels, int32 InStride, uint8 *OutBlock);
+
+	//
+	void RemoveAt(int32 InIndex);
+
+	//
+	TArray<FString> Slots;
+
+	//Thumbnails one after another, each is rows of blocks
+	TArray<uint8> Blocks;
+};
@@ -0,0 +1,74 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+//=============================================================================================================================
+// Decoded screenshots by save slot, least recently used ones are dropped when over the budget. An entry only matches the
+// save file time it was decoded for.
+//=============================================================================================================================
+class SIMPLESAVING_API FScreenshotCache
+{
+public:
+
+	//
+	struct FEntry
+	{
+		//
+		FDateTime DateTime;
+
+		//
+		TArray<uint8> UncompressedBGRA;
+
+		//
+		int32 Wide = 0;
+
+		//
+		int32 Tall = 0;
+
+		//
+		uint64 LastUsed = 0;
+	};
+
+public:
+
+	//
+	const FEntry *Find(const FString &InSlot, const FDateTime &InDateTime);
+
+	//
+	void Add(const FString &InSlot, const FDateTime &InDateTime, int32 InWide, int32 InTall, const TArray<uint8> &InUncompressedBGRA);
+
+	//
+	void Invalidate(const FString &InSlot);
+
+	//
+	void Empty();
+
+	//
+	void SetBudget(int64 InBytes);
+
+	//
+	FORCEINLINE int64 GetBytes() const { return Bytes; }
+
+private:
+
+	//
+	void Trim();
+
+private:
+
+	//Slots are case insensitive like the FString keys
+	TMap<FString, FEntry> Entries;
+
+	//
+	int64 Bytes = 0;
+
+	//
+	int64 Budget = 8 * 1024 * 1024;
+
+	//
+	uint64 Clock = 0;
+};
@@ -0,0 +1,65 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include <atomic>
+
+//=============================================================================================================================
+//
+//=============================================================================================================================
+struct SIMPLESAVING_API FScreenshotDecodeResult
+{
+	//
+	int32 RequestId = INDEX_NONE;
+
+	//
+	TArray<uint8> UncompressedBGRA;
+
+	//
+	int32 Wide = 0;
+
+	//
+	int32 Tall = 0;
+};
+
+//=============================================================================================================================
+// Decodes screenshots on the task graph, any number at a time. Tasks keep the queue alive so the owner can let go of it
+// without waiting for them.
+//=============================================================================================================================
+class SIMPLESAVING_API FScreenshotDecodeQueue : public TSharedFromThis<FScreenshotDecodeQueue, ESPMode::ThreadSafe>
+{
+	//=============================================================================================================================
+	// INPUT / OUTPUT
+	//=============================================================================================================================
+public:
+
+	//Starts decoding, OnDecoded is called on the game thread once the result can be dequeued
+	void Decode(int32 InRequestId, const FString &InFilename, TFunction<void()> &&OnDecoded);
+
+	//Queues a result that didn't need decoding, OnDecoded is called later on the game thread all the same
+	void Finish(FScreenshotDecodeResult &&InResult, TFunction<void()> &&OnDecoded);
+
+	//Game thread only
+	FORCEINLINE bool Dequeue(FScreenshotDecodeResult &OutResult) { return Results.Dequeue(OutResult); }
+
+	//
+	FORCEINLINE int32 GetNumInFlight() const { return InFlight.load(); }
+
+	//
+	static bool LoadScreenshot(const FString &InFilename, FScreenshotDecodeResult &OutResult);
+
+	//=============================================================================================================================
+	//
+	//=============================================================================================================================
+private:
+
+	//Produced by the decode tasks
+	TQueue<FScreenshotDecodeResult, EQueueMode::Mpsc> Results;
+
+	//
+	std::atomic<int32> InFlight { 0 };
+};
@@ -6,7 +6,9 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
-#include "ScreenshotLoaderRunnable.h"
+#include "ScreenshotDecodeQueue.h"
+#include "ScreenshotAtlas.h"
+#include "Styling/SlateBrush.h"
 #include "ScreenshotLoader.generated.h"
 
 //==============================================================================================================
@@ -27,6 +29,30 @@ struct FRequestHeaderScreenshot
 
 	//
 	class UTexture2D** TexturePointer = NULL;
+
+	//Id of the decode, INDEX_NONE until it has been started
+	int32 RequestId = INDEX_NONE;
+
+	//Time of the save file, cached screenshots must match it
+	FDateTime DateTime;
+
+	//Pooled texture that still had this screenshot
+	class UTexture2D *CachedTexture = NULL;
+
+	//Pixels came from the cache of the game instance
+	bool bCached = false;
+};
+
+//==============================================================================================================
+// Which screenshot a texture holds
+//==============================================================================================================
+struct FScreenshotTextureContents
+{
+	//
+	FString Filename;
+
+	//
+	FDateTime DateTime;
 };
 
 //=============================================================================================================================
@@ -49,10 +75,6 @@ protected:
 	virtual void OnUnregister() override;
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
-public:	
-	// Called every frame
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
-
 public:
 
 	//
@@ -66,34 +88,75 @@ public:
 	UFUNCTION(BlueprintCallable, meta = (WorldContext = "WorldContext"))
 	static void FreeScreenshot(const class UObject* WorldContext, class UTexture2D* Texture);
 
+	//Thumbnail of the save as a region of the atlas texture, false if the save has none
+	UFUNCTION(BlueprintCallable, meta = (WorldContext = "WorldContext"))
+	static bool GetAtlasThumbnail(const class UObject* WorldContext, const FString& Filename, FSlateBrush& Brush);
+
 private:
 
 	//
 	UPROPERTY(Transient, VisibleAnywhere, BlueprintReadOnly, Category = "Runtime", meta = (AllowPrivateAccess = true))
 	TArray<class UTexture2D*> Screenshots;
 
+	//Free textures by size, kept alive by Screenshots
+	TMap<FIntPoint, TArray<class UTexture2D*>> ScreenshotPool;
+
 	//
-	UPROPERTY(Transient, VisibleAnywhere, BlueprintReadOnly, Category = "Runtime", meta = (AllowPrivateAccess = true))
-	TArray<class UTexture2D*> ScreenshotPool;
+	TMap<const class UTexture2D*, FScreenshotTextureContents> TextureContents;
 
 	//
 	UPROPERTY(Transient, VisibleAnywhere, BlueprintReadOnly, Category = "Runtime", meta = (AllowPrivateAccess = true))
 	TArray<FRequestHeaderScreenshot> Requests;
 
+	//
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Screenshots", meta = (AllowPrivateAccess = true))
+	int32 MaxConcurrentDecodes = 4;
+
+	//Thumbnails of all saves
 	UPROPERTY(Transient, VisibleAnywhere, BlueprintReadOnly, Category = "Runtime", meta = (AllowPrivateAccess = true))
-	bool bStartedLoading = false;
+	class UTexture2D *AtlasTexture = NULL;
+
+	//
+	FScreenshotAtlas Atlas;
+
+	//Version of the game instance the atlas was read at
+	int32 AtlasVersion = INDEX_NONE;
 
 private:
 
 	//
-	void InitRunnable();
+	void InitDecodeQueue();
+
+	//
+	void DestroyDecodeQueue();
+
+	//Drops requests whose widgets left the screen and starts decoding the rest, visible ones first
+	void StartDecodes();
+
+	//
+	void ProcessDecoded();
+
+	//
+	TFunction<void()> MakeDecodedCallback();
+
+	//Finishes the request with a pooled texture or cached pixels
+	bool CompleteFromCache(FRequestHeaderScreenshot &InOutRequest);
+
+	//
+	class UTexture2D *TakePooledTexture(const FString &InFilename, const FDateTime &InDateTime);
+
+	//
+	void ReturnToPool(class UTexture2D *InTexture);
+
+	//Reads the atlas again if it was written since
+	void UpdateAtlas();
 
 	//
-	void DestroyRunnable();
+	void HandleReceivedData(const FRequestHeaderScreenshot &InRequest, const FScreenshotDecodeResult &InResult);
 
 	//
-	void HandleReceivedData(int32 Wide, int32 Tall, const TArray<uint8>& UncompressedBGRA);
+	TSharedPtr<FScreenshotDecodeQueue, ESPMode::ThreadSafe> DecodeQueue;
 
 	//
-	FScreenshotLoaderRunnable* LoaderRunnable = NULL;
+	int32 NextRequestId = 0;
 };
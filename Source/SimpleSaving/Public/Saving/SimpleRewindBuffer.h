@@ -0,0 +1,150 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "Engine/EngineTypes.h"
+#include "SimpleRewindBuffer.generated.h"
+
+//=================================================================
+// Serialized actor, object or level record, shared by every
+// snapshot it stayed the same in
+//=================================================================
+struct FSimpleRewindRecord
+{
+	//
+	uint32 Hash = 0;
+
+	//
+	TArray<uint8> Data;
+
+	//
+	FORCEINLINE bool Equals(const FSimpleRewindRecord &InOther) const { return Hash == InOther.Hash && Data == InOther.Data; }
+};
+
+//
+typedef TSharedPtr<const FSimpleRewindRecord, ESPMode::ThreadSafe> FSimpleRewindRecordPtr;
+
+//=================================================================
+// 
+//=================================================================
+struct FSimpleRewindSnapshot
+{
+	//Game time it was captured at
+	float Time = 0.0f;
+
+	//Save file with its records left out
+	TArray<uint8> Header;
+
+	//Record counts of global actors, global objects, levels and then actors and objects of each level
+	TArray<int32> Layout;
+
+	//Number of records in the snapshot
+	int32 NumRecords = 0;
+
+	//All records for the keyframe, only those that differ from the previous snapshot for deltas
+	TArray<int32> ChangedIndices;
+	TArray<FSimpleRewindRecordPtr> Changed;
+
+	//Bytes of records first seen in this snapshot
+	int64 Bytes = 0;
+};
+
+//=================================================================
+// Rolling history of the world, captured as deltas against the 
+// previous snapshot. The oldest deltas are folded into the keyframe
+// when over the budget.
+//=================================================================
+UCLASS(BlueprintType)
+class SIMPLESAVING_API USimpleRewindBuffer : public UObject
+{
+	GENERATED_BODY()
+
+	//=================================================================
+	// 
+	//=================================================================
+public:
+
+	//
+	UFUNCTION(BlueprintCallable, meta=(WorldContext="WorldContextObject"))
+	bool Capture(const class UObject *WorldContextObject);
+
+	//Restores the newest snapshot at least this many seconds old, later snapshots are dropped
+	UFUNCTION(BlueprintCallable, meta=(WorldContext="WorldContextObject"))
+	bool Rewind(const class UObject *WorldContextObject, float Seconds);
+
+	//Captures every CaptureInterval seconds until stopped or the world is torn down
+	UFUNCTION(BlueprintCallable, meta=(WorldContext="WorldContextObject"))
+	void StartCapturing(const class UObject *WorldContextObject);
+
+	//
+	UFUNCTION(BlueprintCallable, meta=(WorldContext="WorldContextObject"))
+	void StopCapturing(const class UObject *WorldContextObject);
+
+	//
+	UFUNCTION(BlueprintCallable)
+	void Clear();
+
+	//
+	UFUNCTION(BlueprintPure)
+	int32 GetNumSnapshots() const { return Snapshots.Num(); }
+
+	//
+	UFUNCTION(BlueprintPure)
+	int32 GetMemoryUsageKilobytes() const { return (int32)(TotalBytes / 1024); }
+
+	//
+	UFUNCTION(BlueprintPure)
+	float GetOldestTime() const;
+
+public:
+
+	//
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Rewind")
+	float CaptureInterval = 3.0f;
+
+	//
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Rewind")
+	int32 MaxSnapshots = 20;
+
+	//
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Rewind")
+	int32 MemoryBudgetKilobytes = 16 * 1024;
+
+private:
+
+	//
+	void CaptureFromTimer();
+
+	//
+	void FoldOldest();
+
+	//
+	void BuildRecords(int32 InSnapshot, TArray<FSimpleRewindRecordPtr> &OutRecords) const;
+
+	//
+	class USimpleSaveFile *BuildSaveFile(int32 InSnapshot) const;
+
+	//
+	static int64 GetUniqueBytes(const TArray<FSimpleRewindRecordPtr> &InRecords);
+
+private:
+
+	//The first one is the keyframe
+	TArray<FSimpleRewindSnapshot> Snapshots;
+
+	//Records of the newest snapshot, compared against on the next capture
+	TArray<FSimpleRewindRecordPtr> LastRecords;
+
+	//
+	int64 TotalBytes = 0;
+
+	//
+	FTimerHandle CaptureTimer;
+
+	//
+	TWeakObjectPtr<const class UObject> CaptureContext;
+};
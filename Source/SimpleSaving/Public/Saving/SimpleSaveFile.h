@@ -7,8 +7,106 @@
 #include "CoreMinimal.h"
 #include "GameFramework/SaveGame.h"
 #include "SaveData.h"
+#include "Async/Future.h"
+#include <atomic>
 #include "SimpleSaveFile.generated.h"
 
+//=================================================================
+// Saveable layout of a class or struct, gathered once per save or
+// restore so properties don't need to be searched by name
+//=================================================================
+struct FSimpleSaveClassLayout
+{
+	//Hash of the saveable properties, compared against FCustomSaveData::SchemaHash
+	int32 SchemaHash = 0;
+
+	//Saveable properties in the order SaveCustomData_Internal writes them
+	TArray<class FProperty*> Singles;
+	TArray<class FProperty*> Arrays;
+	TArray<class FMapProperty*> Maps;
+
+	//All properties by name for records saved with a different layout
+	TMap<FName, class FProperty*> Properties;
+
+	//Component classes that are only saved when tagged with ForceSave
+	bool ExcludedComponent = false;
+
+	//Has SaveGame properties or implements the save interface
+	bool HasSaveState = false;
+
+	//Scene components whose relative transform can be restored
+	bool CanMove = false;
+};
+
+//=================================================================
+// 
+//=================================================================
+struct FSimpleDeferredSpawn
+{
+	FSimpleDeferredSpawn(class AActor *InActor, int32 InIndex, bool InGlobal) : Actor(InActor), Index(InIndex), Global(InGlobal) { }
+
+	//
+	class AActor *Actor;
+
+	//Into the global actors or the actors of the current level, the arrays may grow before spawning finishes
+	int32 Index;
+
+	//
+	bool Global;
+};
+
+//=================================================================
+// Single values of one saved record decoded on a worker thread so
+// the game thread only needs to copy them into the object
+//=================================================================
+struct FSimpleDecodedRecord
+{
+	FSimpleDecodedRecord();
+	~FSimpleDecodedRecord();
+
+	//Record this was decoded from and the class it was decoded for
+	const TMap<FName, FString> *Singles = NULL;
+	const class UClass *Class = NULL;
+
+	//Property of each single by position, NULL when it is restored on the game thread
+	TArray<class FProperty*> Properties;
+	TArray<int32> Offsets;
+	TArray<bool> Decoded;
+
+	//Storage for the decoded values
+	TArray<uint8, TAlignedHeapAllocator<16>> Buffer;
+
+	//0 = pending, 1 = decoding, 2 = decoded, 3 = restored on the game thread
+	std::atomic<int32> State{0};
+
+	//Triggered once the worker is done with it
+	class FEvent *DoneEvent = NULL;
+};
+
+//=================================================================
+// 
+//=================================================================
+USTRUCT()
+struct FPooledActors
+{
+	GENERATED_USTRUCT_BODY()
+
+	//
+	UPROPERTY(Transient)
+	TArray<class AActor*> Actors;
+
+	//What each actor had before it was pooled, restored when it is taken
+	struct FState
+	{
+		bool Hidden = false;
+		bool Collision = true;
+		bool Tick = true;
+	};
+
+	//
+	TArray<FState> States;
+};
+
 //=================================================================
 // 
 //=================================================================
@@ -16,6 +114,9 @@ UCLASS()
 class SIMPLESAVING_API USimpleSaveFile : public USaveGame
 {
 	GENERATED_BODY()
+
+	//Splits the save file into records for its snapshots
+	friend class USimpleRewindBuffer;
 	
 	//=================================================================
 	// 
@@ -30,6 +131,10 @@ public:
 	static const FName Name_PlayerPawn;
 	static const FName Name_GameState;
 
+	//
+	virtual void Serialize(FArchive &Ar) override;
+	virtual void BeginDestroy() override;
+
 	//=================================================================
 	// 
 	//=================================================================
@@ -51,6 +156,20 @@ public:
 	UFUNCTION(BlueprintCallable, meta=(WorldContext="WorldContextObject"))
 	static bool LoadGame(const class UObject *WorldContextObject, FString Filename);
 	
+	//Saves into memory for RestoreCheckpoint, also written to the slot in the background if one is given
+	UFUNCTION(BlueprintCallable, meta=(WorldContext="WorldContextObject"))
+	static bool CaptureCheckpoint(const class UObject *WorldContextObject, FString FlushToSlot);
+
+	//Restores the last checkpoint, without reopening the map if we are still in it
+	UFUNCTION(BlueprintCallable, meta=(WorldContext="WorldContextObject"))
+	static bool RestoreCheckpoint(const class UObject *WorldContextObject);
+
+	//Saves every record of the current state into the save file of the game instance
+	static class USimpleSaveFile *SaveForRestore(const class UObject *WorldContextObject);
+
+	//Restores a save file held in memory, in place when allowed and possible
+	static bool RestoreSaveFile(const class UObject *WorldContextObject, class USimpleSaveFile *InLoadGame, bool InAllowInPlace);
+
 	//
 	UFUNCTION(BlueprintCallable, meta=(WorldContext="WorldContextObject"))
 	static bool CopySaveFile(const class UObject *WorldContextObject, FString Source, FString Destination);
@@ -69,9 +188,19 @@ public:
 	UFUNCTION(BlueprintCallable, meta=(WorldContext="WorldContextObject"))
 	static void DebugSavedProperties(const FSimpleSaveData &InData);
 
+	//Saves everything that doesn't need a save file, for comparing against when delta saving
+	static void SaveBaselineProperties(class UObject *InObject, FSimpleSaveData &OutData);
+
+	//Levels other than the current one are packed, this unpacks them until the next save or restore for inspecting them
+	UFUNCTION(BlueprintCallable, Category="Data")
+	void UnpackLevels();
+
 	//Gather classes we might want to load
 	bool GatherClassesToLoad(class UObject *WorldContext, TArray<class TSoftClassPtr<class UObject>> &OutClasses);
 
+	//Same for when the map isn't loaded yet
+	bool GatherClassesForMap(const FName &InMapName, TArray<class TSoftClassPtr<class UObject>> &OutClasses);
+
 #if WITH_EDITOR
 	//
 	bool DebugSaveGame(const class UObject* WorldContext, bool InMultiLevel);
@@ -130,7 +259,7 @@ private:
 	bool GetObjectTag(class UObject* InObject, FName& OutTag, int32& OutIndex, bool& OutGlobal);
 
 	//
-	FActorSaveData *AddActorToSave(FLevelSaveData *InLevelData, class AActor *InActor, const FName &InTag);
+	FActorSaveData *AddActorToSave(FLevelSaveData *InLevelData, class AActor *InActor, const FName &InTag, const FName &InParentTag = NAME_None);
 
 	void AddComponentToSave(FLevelSaveData* InLevelData, const FName& InTag, FActorSaveData* InActorData, class UActorComponent* InComponent);
 
@@ -165,7 +294,16 @@ public:
 
 private:
 
-	static void RestoreCustomData_Internal(class USimpleSaveFile *InFile, class UObject *InObject, const TMap<FName, FString> &Singles, const TMap<FName, FArrayData> &Arrays, const TMap<FName, FMapData> &Maps);
+	static void RestoreCustomData_Internal(class USimpleSaveFile *InFile, class UObject *InObject, const TMap<FName, FString> &Singles, const TMap<FName, FArrayData> &Arrays, const TMap<FName, FMapData> &Maps, int32 InSchemaHash = 0);
+
+	//
+	const FSimpleSaveClassLayout *GetClassLayout(const class UStruct *InStruct);
+
+	//
+	FORCEINLINE static const FSimpleSaveClassLayout *GetClassLayout(class USimpleSaveFile *InFile, const class UStruct *InStruct)
+	{
+		return InFile != NULL ? InFile->GetClassLayout(InStruct) : NULL;
+	}
 
 public:
 
@@ -221,12 +359,27 @@ public:
 	//
 	bool ClearLevelData(const FName &InLevel);
 
+	//Finds the data of a level and unpacks it if needed
+	FLevelSaveData *FindLevelData(const FName &InLevel);
+
+	//Packs every level except the current one on a worker thread, anything touching the levels waits for it first
+	void StartPackingLevels();
+
+	//Puts the records of the levels being packed back, until then the worker holds them
+	void WaitForLevelPacking();
+
 	//
 	static bool StripLevelNameString(const FString& InString, FString& OutString);
 
 	//
 	void SetCurrentMapName(const class UObject * const InObject);
 
+	//
+	static FName GetMapName(const class UObject * const InObject);
+
+	//Same map and every placed actor of the level is still there
+	bool CanRestoreInPlace(const class UObject *WorldContextObject);
+
 	//
 	FORCEINLINE const FName &GetCurrentLevelName() const { return CurrentMapName; }
 
@@ -247,7 +400,7 @@ private:
 	static bool ForceSaveAsSoftObject(class UObject *InObject);
 
 	//
-	FString GetSavingObjectPrefix(bool InGlobal) const;
+	const FString &GetSavingObjectPrefix(bool InGlobal) const;
 
 public:
 
@@ -260,7 +413,7 @@ public:
 
 	//
 	UFUNCTION(BlueprintPure)
-	FString GetLevelSizeString(int32 InLevel) const;
+	FString GetLevelSizeString(int32 InLevel);
 
 	//
 	UFUNCTION(BlueprintPure)
@@ -268,7 +421,7 @@ public:
 
 	//
 	UFUNCTION(BlueprintPure)
-	FString GetTotalSizeString() const;
+	FString GetTotalSizeString();
 
 private:
 
@@ -315,17 +468,68 @@ private:
 	//
 	void RespawnOrFindActors(class UObject *WorldContext, const TArray<FActorSaveData> &InData, TArray<class UObject*> &InObjects, bool InGlobal);
 
+	//
+	void FinishDeferredSpawns();
+
+	//
+	void PruneUnchangedLocalRecords(class USaveGameInstance *InInstance);
+
+	//Finds placed objects that delta saving left out and calls PreRestore on them
+	void GatherUnchangedPlacedObjects(class UObject *WorldContext);
+
+	//Keeps track of local objects saved values point to, so delta saving keeps their records
+	void MarkReferencedObject(bool InGlobal, int32 InIndex);
+
+	//Moves values that are identical between records into shared payloads
+	static void ShareIdenticalPayloads(const TArray<FCustomSaveData*> &InRecords, TArray<FSimpleSaveData> &OutPayloads, bool InGlobal);
+
+	//Shared payloads of the records being restored
+	FORCEINLINE const TArray<FSimpleSaveData> &GetSharedPayloads(const FCustomSaveData &InData) const
+	{
+		return InData.PayloadIsGlobal || CurrentLevelData == NULL ? SharedPayloads : CurrentLevelData->SharedPayloads;
+	}
+
+	//
+	bool ReturnToActorPool(class AActor *InActor);
+
+	//
+	class AActor *TakeFromActorPool(UClass *InClass, const FTransform &InTransform);
+
+	//
+	bool IsInActorPool(const class AActor *InActor) const;
+
+	//
+	void DestroyActorPool();
+
+	//
+	void StartDecodingRecords();
+
+	//
+	void AddDecodedRecord(const FCustomSaveData &InData, bool InGlobal);
+
+	//
+	static void DecodeRecord(FSimpleDecodedRecord &InRecord);
+
+	//
+	FSimpleDecodedRecord *ClaimDecodedRecord(const TMap<FName, FString> &InSingles, const class UClass *InClass);
+
+	//
+	void WaitForDecodedRecords();
+
 	//
 	static bool HandleRestoreStruct(class USimpleSaveFile *InFile, class FProperty *InProperty, const FString &InValue, void *InRawData, int32 InIndex, class UObject *InObject);
 
 	//
-	static bool HandleFixSoftObject(class UObject *InObject, class FProperty *InProperty, FString &InValue);
+	static bool HandleFixSoftObject(class USimpleSaveFile *InFile, class UObject *InObject, const FStringView &InValue, FString &OutValue);
+
+	//Restores a single saved value into a property of any type
+	static void RestoreValue(class USimpleSaveFile *InFile, class FProperty *InProperty, const FString &InValue, void *InRawData, class UObject *InObject);
 
 	//
-	bool HandleRestoreObject_Internal(class FProperty* InProperty, const FString& InValue, void* InRawData, int32 InIndex, class UObject *InObject);
+	bool HandleRestoreObject_Internal(class FProperty* InProperty, const FStringView& InValue, void* InRawData, int32 InIndex, class UObject *InObject);
 
 	//
-	FORCEINLINE static bool HandleRestoreObject(class USimpleSaveFile *InFile, FProperty* InProperty, const FString& InValue, void* InRawData, int32 InIndex, class UObject *InObject)
+	FORCEINLINE static bool HandleRestoreObject(class USimpleSaveFile *InFile, FProperty* InProperty, const FStringView& InValue, void* InRawData, int32 InIndex, class UObject *InObject)
 	{
 		return InFile != NULL && InFile->HandleRestoreObject_Internal(InProperty, InValue, InRawData, InIndex, InObject);
 	}
@@ -341,8 +545,8 @@ public:
 	//
 	FORCEINLINE const TArray<FCustomSaveData> &GetCustomObjects() const { return CustomObjects; }
 
-	//
-	const FLevelSaveData *GetLevelSaveData(const FName &InLevel) const;
+	//Level as it is stored, it is packed unless it is the current one or FindLevelData was used on it
+	const FLevelSaveData *GetLevelSaveData(const FName &InLevel);
 
 	//
 	FORCEINLINE const TArray<TSoftObjectPtr<class UObject>> &GetAssetsToLoad() const { return AssetsToLoad; }
@@ -361,7 +565,7 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Data", meta=(AllowPrivateAccess=true))
 	bool MultiLevelSaveGame;
 
-	//
+	//Records are packed outside of saving and restoring, call UnpackLevels to see them
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Data", meta=(AllowPrivateAccess=true))
 	TArray<FLevelSaveData> Levels;
 
@@ -369,6 +573,10 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Data", meta=(AllowPrivateAccess=true))
 	TArray<FCustomSaveData> CustomObjects;
 
+	//Values of global records that were identical to each other
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Data", meta=(AllowPrivateAccess=true))
+	TArray<FSimpleSaveData> SharedPayloads;
+
 	//
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Data", meta=(AllowPrivateAccess=true))
 	float SaveTime;
@@ -404,6 +612,10 @@ private:
 	UPROPERTY(Transient, VisibleAnywhere, BlueprintReadOnly, Category="Runtime", meta=(AllowPrivateAccess=true))
 	TArray<class UObject*> LocalSaveObjects;
 
+	//Placed objects of a delta saved level that had nothing saved, they still get PreRestore and OnRestore
+	UPROPERTY(Transient)
+	TArray<class UObject*> UnchangedPlacedObjects;
+
 
 	//
 	UPROPERTY(Transient, VisibleAnywhere, BlueprintReadOnly, Category="Runtime", meta=(AllowPrivateAccess=true))
@@ -412,13 +624,75 @@ private:
 	//Array of classes we gathered so we don't need to do it constantly.
 	UPROPERTY(Transient, VisibleAnywhere, BlueprintReadOnly, Category="Runtime", meta=(AllowPrivateAccess=true))
 	TArray<TSoftClassPtr<class UObject>> GatheredClasses;
+
+	//Layouts of classes seen during the current save or restore
+	TMap<const class UStruct*, TUniquePtr<FSimpleSaveClassLayout>> ClassLayouts;
+
+	//Prefix of references to objects in the current level and the map it was built for
+	mutable FString LevelObjectPrefix;
+	mutable FName LevelObjectPrefixMap;
+
+	//Path of the world being restored
+	FString RestoreWorldPath;
+
+	//Buffer values are exported into while saving, kept between saves
+	FString ExportScratch;
+
+	//Local objects that saved values point to
+	TBitArray<> ReferencedLocalObjects;
+
+	//
+	bool QuantizeTransforms = false;
+
+	//Checkpoints are restored over the level as it is, so placed actors can't be left out
+	bool KeepUnchangedRecords = false;
+
+	//Recreated actors waiting for FinishSpawning, kept alive by the save object arrays
+	TArray<FSimpleDeferredSpawn> DeferredSpawns;
+
+	//Actors spawned at their saved transform during the current restore
+	TSet<const class AActor*> SpawnedActors;
+
+	//Objects whose saved data was fully restored before they began play
+	TSet<const class UObject*> PreRestoredObjects;
+
+	//PreRestore is called once even if the data is applied again to resolve references
+	TSet<const class UObject*> PreRestoreCalled;
+
+	//Object references that pointed to objects not restored yet
+	int32 UnresolvedObjectReferences = 0;
+
+	//Restoring over the level as it is, only values that differ are applied
+	bool RestoreInPlace = false;
+
+	//Recreated actors kept by an in-place restore, by their saved name
+	UPROPERTY(Transient)
+	TMap<FName, class AActor*> InPlaceActors;
+
+	//Values left alone by an in-place restore
+	int32 UnchangedValues = 0;
+
+	//Actors removed on restore that can be reused for recreated actors of the same class
+	UPROPERTY(Transient)
+	TMap<class UClass*, FPooledActors> ActorPool;
+
+	//Single values decoded ahead of restoring them, by the address of the saved singles
+	TArray<TUniquePtr<FSimpleDecodedRecord>> DecodedRecords;
+	TMap<const void*, FSimpleDecodedRecord*> DecodedRecordMap;
+	TFuture<void> DecodeTask;
+
+	//Records of the levels, moved out of them and packed once a save is written or a restore is done.
+	//The levels show no records until WaitForLevelPacking, so nothing reads memory the worker is using
+	TFuture<TArray<FLevelSaveData>> PackTask;
 };
 
 //=================================================================
 // 
 //=================================================================
-FORCEINLINE const FLevelSaveData *USimpleSaveFile::GetLevelSaveData(const FName &InLevel) const
+FORCEINLINE const FLevelSaveData *USimpleSaveFile::GetLevelSaveData(const FName &InLevel)
 {
+	WaitForLevelPacking();
+
 	for (int32 i=Levels.Num()-1; i>=0; i--)
 	{
 		if (Levels.GetData()[i].LevelName == InLevel)
@@ -491,5 +765,6 @@ FORCEINLINE FCustomSaveData *FindCustomData(int32 ObjectIndex, TArray<FCustomSav
 //=================================================================
 FORCEINLINE void USimpleSaveFile::RestoreCustomData(class UObject* InObject, const FCustomSaveData& InData)
 {
-	RestoreCustomData_Internal(this, InObject, InData.Singles, InData.Arrays, InData.Maps);
+	const TArray<FSimpleSaveData> &Payloads = GetSharedPayloads(InData);
+	RestoreCustomData_Internal(this, InObject, InData.GetSingles(Payloads), InData.GetArrays(Payloads), InData.GetMaps(Payloads), InData.SchemaHash);
 }
\ No newline at end of file
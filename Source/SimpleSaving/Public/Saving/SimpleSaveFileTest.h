@@ -3,6 +3,33 @@
 #include "CoreMinimal.h"
 #include "SimpleSaveFileTest.generated.h"
 
+//=================================================================
+// Inventory style struct for the struct parsing benchmark
+//=================================================================
+USTRUCT()
+struct FSaveTestInventoryItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY(SaveGame)
+	FName ItemId;
+
+	UPROPERTY(SaveGame)
+	FString Description;
+
+	UPROPERTY(SaveGame)
+	int32 Count = 0;
+
+	UPROPERTY(SaveGame)
+	float Durability = 0.0f;
+
+	UPROPERTY(SaveGame)
+	FVector Offset = FVector::ZeroVector;
+
+	UPROPERTY(SaveGame)
+	TArray<int32> Modifiers;
+};
+
 //=================================================================
 // Class for testing saving
 //=================================================================
@@ -27,4 +54,21 @@ public:
 
 	UPROPERTY(SaveGame)
 	TMap<int32, float> SomeMap;
+};
+
+//=================================================================
+// Class for benchmarking struct restoring
+//=================================================================
+UCLASS()
+class USaveTestInventory : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	void Randomize(int32 InCount);
+	bool Matches(class USaveTestInventory *InOther) const;
+
+	UPROPERTY(SaveGame)
+	TArray<FSaveTestInventoryItem> Items;
 };
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include "GameFramework/SaveGame.h"
 #include "SimpleHeaderData.h"
 #include "Engine/LatentActionManager.h"
+#include "Async/Future.h"
 #include "SimpleSaveHeader.generated.h"
 
 //=================================================================
@@ -39,11 +40,14 @@ public:
 public:
 
 	//
-	void Screenshot(const FString& Filename);
+	void Screenshot(const FString& Filename, int32 InHeight, int32 InQuality);
 
 	//
 	void AcceptScreenshot(int32 InSizeX, int32 InSizeY, const TArray<FColor>& InImageData);
 
+	//
+	static void DownscaleScreenshot(int32 InSizeX, int32 InSizeY, const TArray<FColor> &InImageData, int32 InTargetX, int32 InTargetY, TArray<FColor> &OutData);
+
 public:
 
 	//
@@ -53,4 +57,13 @@ public:
 	//
 	UPROPERTY(Transient, VisibleAnywhere, BlueprintReadOnly, Category = "Runtime", meta = (AllowPrivateAccess = true))
 	TArray<FString> FilesRequestingScreenshot;
+
+private:
+
+	//
+	int32 ScreenshotHeight = 200;
+	int32 ScreenshotQuality = 85;
+
+	//Scaling, encoding and writing of the previous screenshot
+	TFuture<void> ScreenshotTask;
 };
@@ -0,0 +1,99 @@
+// Copyright Tero "Au-heppa" Knuutinen 2025.
+// Free to use for any personal project or company with less than 13 employees
+// Do not use to train AI / LLM / neural network
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "Async/Future.h"
+#include "Engine/StreamableManager.h"
+#include "SimpleSavePrefetch.generated.h"
+
+//=================================================================
+// Warms up the save the player is about to load. The file is read
+// on a worker, then its classes and assets are loaded at a low
+// priority while the player decides. USimpleSaveFile::LoadGame takes
+// the result if it was for the same save.
+//=================================================================
+UCLASS(BlueprintType)
+class SIMPLESAVING_API USimpleSavePrefetch : public UObject
+{
+	GENERATED_BODY()
+
+	//=================================================================
+	// 
+	//=================================================================
+public:
+
+	//Cancels whatever was prefetched before
+	UFUNCTION(BlueprintCallable)
+	void Prefetch(const FString &Filename);
+
+	//
+	UFUNCTION(BlueprintCallable)
+	void Cancel();
+
+	//Only if this save is the one being prefetched
+	UFUNCTION(BlueprintCallable)
+	void CancelFor(const FString &Filename);
+
+	//
+	UFUNCTION(BlueprintPure)
+	bool IsPrefetching(const FString &Filename) const { return !PrefetchFilename.IsEmpty() && PrefetchFilename.Equals(Filename, ESearchCase::IgnoreCase); }
+
+	//Waits for the read if it is still going, the loads are kept until ReleaseLoads
+	class USimpleSaveFile *TakeSaveFile(const FString &Filename);
+
+	//Restore is done, the loaded assets are held by the world now
+	void ReleaseLoads();
+
+	//A read of the save in progress would be torn, it is thrown away and the save isn't prefetched until EndWrite
+	void BeginWrite(const FString &Filename);
+	void EndWrite(const FString &Filename);
+
+public:
+
+	//Below the default so the menu itself doesn't wait for these
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Prefetch")
+	int32 LoadPriority = -1;
+
+	//Seconds a prefetched save is kept if it isn't loaded or another save isn't prefetched, zero keeps it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Prefetch")
+	float Timeout = 20.0f;
+
+private:
+
+	//
+	void OnReadFinished(int32 InGeneration);
+
+	//
+	void StartLoads();
+
+private:
+
+	//
+	FString PrefetchFilename;
+
+	//Saves being written
+	TSet<FString> WritingFiles;
+
+	//Results of older prefetches are thrown away
+	int32 Generation = 0;
+
+	//Bytes of the save file
+	TFuture<TArray<uint8>> ReadTask;
+
+	//
+	UPROPERTY(Transient)
+	class USimpleSaveFile *SaveFile = NULL;
+
+	//
+	FStreamableManager StreamableManager;
+
+	//
+	TSharedPtr<FStreamableHandle> LoadHandle;
+
+	//Loads of the save that was taken, held until the restore finishes
+	TSharedPtr<FStreamableHandle> KeptHandle;
+};
@@ -30,6 +30,17 @@ public:
 	//
 	FORCEINLINE const FString &GetFilename() const { return Filename; }
 
+	//
+	FORCEINLINE const FDateTime &GetDateTime() const { return DateTime; }
+
+	//Row left the screen and the widget went back to the pool, free the screenshot here
+	void Release();
+
+	//
+	UFUNCTION(BlueprintNativeEvent)
+	void OnRelease();
+	virtual void OnRelease_Implementation() { }
+
 	//
 	UFUNCTION(BlueprintCallable)
 	void Click();
@@ -46,6 +57,25 @@ public:
 	UPROPERTY(BlueprintAssignable)
 	FSaveWidgetEvent OnClick;
 
+	//Start reading the save when hovered or focused, it is likely to be loaded next. It is kept until
+	//another save is prefetched or the prefetch times out, leaving the row just before clicking is common
+	UFUNCTION(BlueprintCallable)
+	void StartPrefetch();
+
+	//
+	UFUNCTION(BlueprintCallable)
+	void StopPrefetch();
+
+	//
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Prefetch")
+	bool PrefetchOnHover = true;
+
+protected:
+
+	//
+	virtual void NativeOnMouseEnter(const FGeometry &InGeometry, const FPointerEvent &InMouseEvent) override;
+	virtual void NativeOnAddedToFocusPath(const FFocusEvent &InFocusEvent) override;
+
 	//
 private:
 
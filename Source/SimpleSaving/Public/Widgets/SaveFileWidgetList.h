@@ -29,10 +29,18 @@ public:
 	void Update();
 	virtual void Update_Implementation() { }
 
-	//
+	//Rows are pooled, and only created for the visible part when RowHeight is set and the parent is in a scroll box
 	UFUNCTION(BlueprintCallable)
 	bool UpdateList(TSoftClassPtr<class USaveFileWidget> InClass, class UPanelWidget *InParent);
 
+	//Height of one row, zero creates a widget for every save
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="List")
+	float RowHeight = 0.0f;
+
+	//Rows kept above and below the visible ones
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="List")
+	int32 ExtraRows = 2;
+
 	//
 	UFUNCTION(BlueprintNativeEvent)
 	void OnFileClicked(const FString &InFilename);
@@ -47,9 +55,51 @@ public:
 
 private:
 
+	//Applies removes, inserts and moves for the rows in view
+	bool UpdateRows();
+
+	//
+	UFUNCTION()
+	void OnListScrolled(float CurrentOffset);
+
+	//
+	void GetVisibleRows(int32 InNum, int32 &OutFirst, int32 &OutEnd) const;
+
+	//
+	class USaveFileWidget *TakeWidget();
+
+	//
+	void PlaceChild(class UWidget *InWidget, int32 InIndex);
+
+	//Every widget created, visible and pooled
 	UPROPERTY()
 	TArray<class USaveFileWidget*> Widgets;
 
+	//Rows on screen by save file
+	TMap<FString, class USaveFileWidget*> VisibleWidgets;
+
+	//
+	TArray<class USaveFileWidget*> Pool;
+
+	//Take the space of the rows that have no widget
+	UPROPERTY(Transient)
+	class USpacer *TopSpacer = NULL;
+
+	UPROPERTY(Transient)
+	class USpacer *BottomSpacer = NULL;
+
+	//
+	UPROPERTY(Transient)
+	TSubclassOf<class USaveFileWidget> WidgetClass;
+
+	//
+	UPROPERTY(Transient)
+	TWeakObjectPtr<class UPanelWidget> Parent;
+
+	//
+	UPROPERTY(Transient)
+	TWeakObjectPtr<class UScrollBox> ScrollBox;
+
 	//
 	UPROPERTY(Category="Runtime", VisibleAnywhere, BlueprintReadOnly, meta=(AllowPrivateAccess=true))
 	TWeakObjectPtr<class USaveGameInstance> GameInstance;